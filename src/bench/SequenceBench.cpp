@@ -0,0 +1,424 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "config-syracuse.hpp"
+#include "core/BasicSequence.hpp"
+#include "core/CollatzSequence.hpp"
+#include "core/ConvergenceCheck.hpp"
+#include "core/Engine.hpp"
+#include "core/JumpTable.hpp"
+#include "core/RecordFinder.hpp"
+#include "core/ResultCache.hpp"
+#include "core/ResultTable.hpp"
+#include "core/Simd.hpp"
+#include "core/Sweep.hpp"
+#include "core/ThreadPool.hpp"
+#include "core/Trajectory.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+
+using namespace sequence;
+
+namespace
+{
+    // The runs start at 2^range(0), so that the benchmarks cover both the
+    // short trajectories and the ones close to 64 bits.
+    int64_t base(const benchmark::State& state)
+    {
+        return int64_t(1) << state.range(0);
+    }
+
+    // Reports the number of evaluations of the recurrence relation, which
+    // is the unit shared by all the engines.
+    void setSteps(benchmark::State& state, const double steps)
+    {
+        state.counters["steps/s"] =
+            benchmark::Counter(steps, benchmark::Counter::kIsRate);
+        state.counters["ns/step"] = benchmark::Counter(
+            steps / 1e9,
+            benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    }
+
+    double steps(const ResultTable& table)
+    {
+        return static_cast<double>(std::accumulate(table.cycleLens().begin(),
+                                                   table.cycleLens().end(),
+                                                   uint64_t(0)));
+    }
+
+    // Recurrence relations of order 1 to 3, the ones of order 2 and 3
+    // being reduced so that they never overflow.
+    constexpr int64_t modulus = 1000003;
+
+    int64_t order2(const Sequence::vec_t& un_)
+    {
+        return (un_[0] + un_[1]) % modulus;
+    }
+
+    int64_t order3(const Sequence::vec_t& un_)
+    {
+        return (un_[0] + un_[1] + un_[2]) % modulus;
+    }
+
+    const Sequence::vec_t& uz(const std::size_t order)
+    {
+        static const Sequence::vec_t uz[] = { { 0 }, { 27 }, { 0, 1 },
+                                              { 0, 0, 1 } };
+        return uz[order];
+    }
+
+    Sequence generic(const std::size_t order)
+    {
+        switch (order) {
+        case 1:
+            return Sequence(uz(1), &CollatzSequence::relation);
+        case 2:
+            return Sequence(uz(2), &order2);
+        default:
+            return Sequence(uz(3), &order3);
+        }
+    }
+
+    // Whether both searches found the same records, the sieve being only
+    // checked against the search running all the initial terms.
+    bool same(const RecordFinder::Records& a, const RecordFinder::Records& b)
+    {
+        const auto equal = [](const std::vector<RecordFinder::Record>& x,
+                              const std::vector<RecordFinder::Record>& y) {
+            return std::equal(x.begin(), x.end(), y.begin(), y.end(),
+                [](const RecordFinder::Record& i,
+                   const RecordFinder::Record& j) {
+                    return (i.uz == j.uz) && (i.cycleLen == j.cycleLen)
+                           && (i.maxTerm == j.maxTerm);
+                });
+        };
+
+        return equal(a.longest, b.longest) && equal(a.highest, b.highest);
+    }
+}
+
+// Sequence::at() -------------------------------------------------------------
+
+static void BM_SequenceAt(benchmark::State& state)
+{
+    const auto order = static_cast<std::size_t>(state.range(0));
+    const auto n = static_cast<Sequence::vec_t::size_type>(state.range(1));
+    const Sequence seq = generic(order);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(seq.at(n));
+
+    setSteps(state, static_cast<double>(state.iterations() * n));
+}
+BENCHMARK(BM_SequenceAt)
+    ->ArgNames({ "order", "n" })
+    ->ArgsProduct({ { 1, 2, 3 }, { 1 << 10, 1 << 16 } });
+
+template<std::size_t Order>
+static void BM_BasicSequenceAt(benchmark::State& state)
+{
+    const auto n = static_cast<std::size_t>(state.range(0));
+    const auto seq = makeSequence<Order>(
+        [](const std::array<int64_t, Order>& un_) {
+            if constexpr (Order == 1)
+                return collatz::step(un_[0]);
+            else
+                return std::accumulate(un_.begin(), un_.end(), int64_t(0))
+                       % modulus;
+        });
+
+    std::array<int64_t, Order> window;
+    std::copy(uz(Order).begin(), uz(Order).end(), window.begin());
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(seq.at(n, window));
+
+    setSteps(state, static_cast<double>(state.iterations() * n));
+}
+BENCHMARK_TEMPLATE(BM_BasicSequenceAt, 1)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_BasicSequenceAt, 2)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_BasicSequenceAt, 3)->Arg(1 << 10)->Arg(1 << 16);
+
+// doUntil() ------------------------------------------------------------------
+
+static void BM_SequenceDoUntil(benchmark::State& state)
+{
+    const Sequence seq({}, &CollatzSequence::relation);
+    const int64_t first = base(state);
+    int64_t uz = first;
+    double steps = 0;
+
+    for (auto _ : state) {
+        steps += static_cast<double>(seq.doUntil(1, { uz }).cycleLen);
+        uz = (uz - first + 1) % 4096 + first;
+    }
+
+    setSteps(state, steps);
+}
+BENCHMARK(BM_SequenceDoUntil)->ArgName("log2(uz)")->Arg(0)->Arg(20)->Arg(40);
+
+static void BM_SequenceDoUntilCycle(benchmark::State& state)
+{
+    const Sequence seq({}, &CollatzSequence::relation);
+    const int64_t first = base(state);
+    int64_t uz = first;
+    double steps = 0;
+
+    for (auto _ : state) {
+        const auto ret = seq.doUntilCycle(1 << 20, { uz });
+        steps += static_cast<double>(ret.preperiod + ret.cycleLen);
+        uz = (uz - first + 1) % 4096 + first;
+    }
+
+    setSteps(state, steps);
+}
+BENCHMARK(BM_SequenceDoUntilCycle)
+    ->ArgName("log2(uz)")
+    ->Arg(0)->Arg(20)->Arg(40);
+
+static void BM_CollatzDoUntil(benchmark::State& state)
+{
+    CollatzSequence seq;
+    const int64_t first = base(state);
+    int64_t uz = first;
+    double steps = 0;
+
+    if (state.range(1) != 0)
+        seq.withJumpTable(std::make_shared<JumpTable>());
+
+    for (auto _ : state) {
+        steps += static_cast<double>(seq.doUntilWide(1, { uz }).cycleLen);
+        uz = (uz - first + 1) % 4096 + first;
+    }
+
+    setSteps(state, steps);
+}
+BENCHMARK(BM_CollatzDoUntil)
+    ->ArgNames({ "log2(uz)", "jumps" })
+    ->ArgsProduct({ { 0, 20, 40, 60 }, { 0, 1 } });
+
+static void BM_CollatzDoUntilRecord(benchmark::State& state)
+{
+    CollatzSequence seq;
+    Trajectory trajectory;
+    const int64_t first = base(state);
+    int64_t uz = first;
+    double steps = 0;
+
+    for (auto _ : state) {
+        steps += static_cast<double>(
+            seq.doUntilWide(1, { uz }, trajectory).cycleLen);
+        uz = (uz - first + 1) % 4096 + first;
+    }
+
+    setSteps(state, steps);
+}
+BENCHMARK(BM_CollatzDoUntilRecord)
+    ->ArgName("log2(uz)")
+    ->Arg(0)->Arg(20)->Arg(40)->Arg(60);
+
+// loadNUntil() ---------------------------------------------------------------
+
+static void BM_SequenceLoadNUntil(benchmark::State& state)
+{
+    Sequence seq({ base(state) }, &CollatzSequence::relation);
+    double total = 0;
+
+    for (auto _ : state)
+        total += steps(*seq.loadNUntil(1 << 14, 1));
+
+    setSteps(state, total);
+}
+BENCHMARK(BM_SequenceLoadNUntil)
+    ->ArgName("log2(uz)")
+    ->Arg(0)
+    ->Arg(40)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+static void BM_CollatzLoadNUntil(benchmark::State& state)
+{
+    CollatzSequence seq(base(state));
+    double total = 0;
+
+    seq.withJumpTable(std::make_shared<JumpTable>());
+
+    if (state.range(1) != 0)
+        seq.withCache(std::make_shared<ResultCache>(1, 1 << 20));
+
+    for (auto _ : state)
+        total += steps(*seq.loadNUntil(1 << 18, 1));
+
+    setSteps(state, total);
+}
+BENCHMARK(BM_CollatzLoadNUntil)
+    ->ArgNames({ "log2(uz)", "cache" })
+    ->ArgsProduct({ { 0, 40, 60 }, { 0, 1 } })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+static void BM_CollatzLoadNUntilBatch(benchmark::State& state)
+{
+    const CollatzSequence seq(base(state));
+    double total = 0;
+
+    for (auto _ : state)
+        total += steps(*seq.loadNUntilBatch(1 << 18, 1));
+
+    state.SetLabel(simd::isa());
+    setSteps(state, total);
+}
+BENCHMARK(BM_CollatzLoadNUntilBatch)
+    ->ArgName("log2(uz)")
+    ->Arg(0)
+    ->Arg(40)
+    ->Arg(60)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Sweep ----------------------------------------------------------------------
+
+static void BM_SweepRun(benchmark::State& state)
+{
+    const auto name = Engine::names().at(static_cast<std::size_t>(
+        state.range(1)));
+    const CollatzSequence seq(base(state));
+    const auto sweep = Sweep(seq, 1).withEngine(Engine::make(name));
+    double total = 0;
+
+    for (auto _ : state)
+        sweep.run(1 << 18, [&](const ResultTable& block) {
+            total += steps(block);
+        });
+
+    state.SetLabel(name);
+    setSteps(state, total);
+}
+BENCHMARK(BM_SweepRun)
+    ->ArgNames({ "log2(uz)", "engine" })
+    ->ArgsProduct({ { 0, 40 },
+                    benchmark::CreateDenseRange(
+                        0, static_cast<int64_t>(Engine::names().size()) - 1,
+                        1) })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// RecordFinder ---------------------------------------------------------------
+
+static void BM_RecordFinderFind(benchmark::State& state)
+{
+    CollatzSequence seq;
+    seq.withJumpTable(std::make_shared<JumpTable>());
+
+    auto finder = RecordFinder(seq)
+                      .withStatistic(static_cast<RecordFinder::Statistic>(
+                          state.range(0)))
+                      .withCount(static_cast<RecordFinder::size_type>(
+                          state.range(2)));
+
+    if (state.range(1) != 0) {
+        const auto expected = finder.withSieve(false).find(1, 1 << 20);
+
+        if (!same(finder.withSieve(true).find(1, 1 << 20), expected)) {
+            state.SkipWithError("The sieve changes the records.");
+            return;
+        }
+    } else {
+        finder.withSieve(false);
+    }
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(finder.find(1, 1 << 20));
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) << 20);
+}
+BENCHMARK(BM_RecordFinderFind)
+    ->ArgNames({ "statistic", "sieve", "count" })
+    ->ArgsProduct({ { RecordFinder::CycleLen, RecordFinder::Both }, { 0, 1 },
+                    { 1, 16 } })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// ConvergenceCheck -----------------------------------------------------------
+
+static void BM_ConvergenceCheckRun(benchmark::State& state)
+{
+    const auto bits = static_cast<unsigned int>(state.range(0));
+    const ConvergenceCheck check(
+        (bits != 0) ? std::make_shared<ResidueSieve>(bits) : nullptr);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(check.run(int64_t(1) << 40,
+                                           (int64_t(1) << 40) + (1 << 20)));
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) << 20);
+}
+BENCHMARK(BM_ConvergenceCheckRun)
+    ->ArgName("bits")
+    ->Arg(0)
+    ->Arg(10)
+    ->Arg(16)
+    ->Arg(24)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// ThreadPool -----------------------------------------------------------------
+
+static void BM_ThreadPoolParallelFor(benchmark::State& state)
+{
+    const auto chunk = static_cast<uint64_t>(state.range(0));
+    std::atomic<uint64_t> sum(0);
+
+    for (auto _ : state) {
+        ThreadPool::global().parallelFor(0, 1 << 16, chunk,
+            [&](const uint64_t begin, const uint64_t end) {
+                sum.fetch_add(end - begin, std::memory_order_relaxed);
+            });
+    }
+
+    benchmark::DoNotOptimize(sum.load());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) << 16);
+}
+BENCHMARK(BM_ThreadPoolParallelFor)
+    ->ArgName("chunk")
+    ->Arg(0)
+    ->Arg(64)
+    ->Arg(4096)
+    ->UseRealTime();
+
+// The build is recorded in the context of the results, so that the
+// baselines of several builds can be told apart.
+int main(int argc, char* argv[])
+{
+    benchmark::AddCustomContext("syracuse_flavour", SYRACUSE_FLAVOUR);
+    benchmark::AddCustomContext("syracuse_compiler", SYRACUSE_COMPILER);
+    benchmark::AddCustomContext("syracuse_cxx_flags", SYRACUSE_CXX_FLAGS);
+
+    benchmark::Initialize(&argc, argv);
+
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return EXIT_FAILURE;
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return EXIT_SUCCESS;
+}
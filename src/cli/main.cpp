@@ -0,0 +1,637 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/BinaryWriter.hpp"
+#include "core/Checkpoint.hpp"
+#include "core/CollatzSequence.hpp"
+#include "core/ConvergenceCheck.hpp"
+#include "core/Coordinator.hpp"
+#include "core/Engine.hpp"
+#include "core/JumpTable.hpp"
+#include "core/Metrics.hpp"
+#include "core/RecordFinder.hpp"
+#include "core/ResultCache.hpp"
+#include "core/ResultTable.hpp"
+#include "core/Socket.hpp"
+#include "core/Sweep.hpp"
+#include "core/StoppingTable.hpp"
+#include "core/SweepStore.hpp"
+#include "core/TextWriter.hpp"
+#include "core/Worker.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    void usage(const char* name)
+    {
+        std::string engines;
+
+        for (const auto& i : sequence::Engine::names())
+            engines += (engines.empty() ? "" : ", ") + i;
+
+        std::cerr << "Usage: " << name << " [-o FILE] [-f FORMAT] [-b SIZE] "
+                     "[-c FILE | -r DIR]\n"
+                     "       [-s | -t K [-a]] [-e ENGINE] [-T FILE] [-m FILE] "
+                     "FIRST COUNT [VALUE [STEP]]\n"
+                     "       " << name << " [-o FILE] [-m FILE] -g [-S FILE] "
+                     "FIRST COUNT\n"
+                     "       " << name << " -l PORT -o DIR [-k SIZE] "
+                     "FIRST COUNT [VALUE [STEP]]\n"
+                     "       " << name << " -w HOST:PORT [-b SIZE]\n"
+                     "Run the Syracuse sequence until VALUE (1 by default) "
+                     "for COUNT initial terms,\nstarting from FIRST and "
+                     "incremented by STEP (1 by default).\n\n"
+                     "  -o FILE    write the results to FILE instead of the "
+                     "standard output\n"
+                     "  -f FORMAT  write the results as text (the default) "
+                     "or binary, the latter\n"
+                     "             needing -o\n"
+                     "  -b SIZE    evaluate the runs by blocks of SIZE\n"
+                     "  -e ENGINE  evaluate the runs with ENGINE, among "
+                  << engines << "\n"
+                     "  -c FILE    save the progress to FILE, and resume "
+                     "from it if it exists;\n"
+                     "             the results are then appended to the "
+                     "output, which needs\n"
+                     "             -o unless with -s\n"
+                     "  -r DIR     keep the runs in DIR as binary files, and "
+                     "only run the ones\n"
+                     "             not kept there yet\n"
+                     "  -s         write a summary of the runs instead of "
+                     "the results\n"
+                     "  -t K       write the K initial terms having the "
+                     "longest cycles and the K\n"
+                     "             having the highest maximum terms instead "
+                     "of the results,\n"
+                     "             skipping the ones that cannot be among "
+                     "them; needs a STEP of 1\n"
+                     "  -a         with -t, run all the initial terms, so "
+                     "that the records can be\n"
+                     "             checked against the ones found by "
+                     "skipping them\n"
+                     "  -g         check that the initial terms fall below "
+                     "themselves instead of\n"
+                     "             writing the results, skipping the ones "
+                     "known to fall from their\n"
+                     "             low bits, and write the longest glide\n"
+                     "  -S FILE    map the residue sieve of -g from FILE, "
+                     "building and saving it\n"
+                     "             first if it does not exist\n"
+                     "  -T FILE    stop the runs as soon as they fall into "
+                     "the table of the low\n"
+                     "             stopping times mapped from FILE, building "
+                     "and saving it first\n"
+                     "             if it does not exist; needs a VALUE of "
+                     "1\n"
+                     "  -m FILE    write the metrics of the runs to FILE "
+                     "every second and once\n"
+                     "             done, as JSON if FILE ends with .json and "
+                     "as Prometheus text\n"
+                     "             otherwise; needs a build configured "
+                     "WITH_METRICS\n"
+                     "  -l PORT    hand out the runs to the workers "
+                     "connecting to PORT, and store\n"
+                     "             them by chunks in DIR as binary files; "
+                     "the chunks already\n"
+                     "             stored are not run again\n"
+                     "  -k SIZE    hand out the runs by chunks of SIZE\n"
+                     "  -w HOST:PORT\n"
+                     "             run the chunks handed out by the "
+                     "coordinator at HOST:PORT\n";
+    }
+
+    struct Options
+    {
+        const char* output = nullptr;
+        bool binary = false;
+        uint64_t blockSize = 0;
+        const char* checkpoint = nullptr;
+        const char* store = nullptr;
+        bool summary = false;
+        uint64_t records = 0;
+        bool all = false;
+        bool glide = false;
+        const char* sieve = nullptr;
+        const char* stops = nullptr;
+        std::string engine;
+        const char* metrics = nullptr;
+        long port = -1;
+        uint64_t chunkSize = 0;
+        std::string coordinator;
+        std::vector<const char*> args;
+
+        ~Options();
+    };
+
+    // Out of line, the destructor being only run once or when unwinding.
+    Options::~Options() = default;
+
+    const char* mode(const Options& opts)
+    {
+        if (opts.binary)
+            return "wb";
+
+        return (opts.checkpoint != nullptr) ? "a" : "w";
+    }
+
+    void write(std::FILE* file, const sequence::Summary& summary,
+               const int64_t first, const int64_t step)
+    {
+        const auto uz = [&](const uint64_t i) {
+            return std::to_string(first + static_cast<int64_t>(i) * step);
+        };
+
+        const std::string text =
+            "runs " + std::to_string(summary.runs)
+            + "\ntotalCycleLen " + std::to_string(summary.totalCycleLen)
+            + "\nlongestCycle " + uz(summary.longestRun) + ' '
+            + std::to_string(summary.longestCycleLen)
+            + "\nhighestMaxTerm " + uz(summary.highestRun) + ' '
+            + core::toString(summary.highestMaxTerm) + '\n';
+
+        if (std::fputs(text.c_str(), file) == EOF)
+            throw std::runtime_error(std::strerror(errno));
+    }
+
+    void write(std::FILE* file,
+               const sequence::RecordFinder::Records& records)
+    {
+        std::string text = "runs " + std::to_string(records.runs)
+                           + "\nskipped " + std::to_string(records.skipped)
+                           + '\n';
+
+        for (const auto& i : records.longest) {
+            text += "longestCycle " + std::to_string(i.uz) + ' '
+                    + std::to_string(i.cycleLen) + '\n';
+        }
+
+        for (const auto& i : records.highest) {
+            text += "highestMaxTerm " + std::to_string(i.uz) + ' '
+                    + core::toString(i.maxTerm) + '\n';
+        }
+
+        if (std::fputs(text.c_str(), file) == EOF)
+            throw std::runtime_error(std::strerror(errno));
+    }
+
+    void write(std::FILE* file,
+               const sequence::ConvergenceCheck::Report& report,
+               const int64_t first)
+    {
+        const auto& summary = report.summary;
+        const auto uz = [&](const uint64_t i) {
+            return std::to_string(first + static_cast<int64_t>(i));
+        };
+
+        std::string text = "runs " + std::to_string(summary.runs)
+                           + "\nskipped " + std::to_string(report.skipped)
+                           + "\ntotalGlide "
+                           + std::to_string(summary.totalCycleLen) + '\n';
+
+        if (summary.runs != 0) {
+            text += "longestGlide " + uz(summary.longestRun) + ' '
+                    + std::to_string(summary.longestCycleLen)
+                    + "\nhighestMaxTerm " + uz(summary.highestRun) + ' '
+                    + core::toString(summary.highestMaxTerm) + '\n';
+        }
+
+        if (std::fputs(text.c_str(), file) == EOF)
+            throw std::runtime_error(std::strerror(errno));
+    }
+
+    // Maps the sieve saved to `path`, or builds it and saves it there if
+    // there is none yet.
+    Ref<const sequence::ResidueSieve> sieve(const char* path)
+    {
+        if (path != nullptr) {
+            if (std::FILE* file = std::fopen(path, "rb")) {
+                std::fclose(file);
+                return std::make_shared<sequence::ResidueSieve>(
+                    std::string(path));
+            }
+        }
+
+        auto ret = std::make_shared<sequence::ResidueSieve>();
+
+        if (path != nullptr)
+            ret->save(path);
+
+        return ret;
+    }
+
+    // Maps the stopping table saved to `path`, or builds it and saves it
+    // there if there is none yet.
+    Ref<const sequence::StoppingTable> stoppingTable(const char* path)
+    {
+        if (std::FILE* file = std::fopen(path, "rb")) {
+            std::fclose(file);
+            return std::make_shared<sequence::StoppingTable>(
+                std::string(path));
+        }
+
+        auto ret = std::make_shared<sequence::StoppingTable>();
+        ret->save(path);
+        return ret;
+    }
+
+    // Throws std::invalid_argument on an unknown option.
+    Options parse(int argc, char* argv[])
+    {
+        Options ret;
+
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+
+            if (arg == "-s") {
+                ret.summary = true;
+            } else if (arg == "-a") {
+                ret.all = true;
+            } else if (arg == "-g") {
+                ret.glide = true;
+            } else if (((arg == "-o") || (arg == "-f") || (arg == "-b")
+                        || (arg == "-c") || (arg == "-l") || (arg == "-k")
+                        || (arg == "-t") || (arg == "-w") || (arg == "-S")
+                        || (arg == "-T") || (arg == "-e") || (arg == "-m")
+                        || (arg == "-r"))
+                       && (i + 1 < argc)) {
+                const std::string param = argv[++i];
+
+                if (arg == "-o")
+                    ret.output = argv[i];
+                else if (arg == "-S")
+                    ret.sieve = argv[i];
+                else if (arg == "-T")
+                    ret.stops = argv[i];
+                else if (arg == "-m")
+                    ret.metrics = argv[i];
+                else if (arg == "-c")
+                    ret.checkpoint = argv[i];
+                else if (arg == "-r")
+                    ret.store = argv[i];
+                else if (arg == "-b")
+                    ret.blockSize = std::stoull(param);
+                else if (arg == "-k")
+                    ret.chunkSize = std::stoull(param);
+                else if (arg == "-t")
+                    ret.records = std::stoull(param);
+                else if (arg == "-w")
+                    ret.coordinator = param;
+                else if (arg == "-e")
+                    ret.engine = param;
+                else if (arg == "-l")
+                    ret.port = std::stol(param);
+                else if ((param == "text") || (param == "binary"))
+                    ret.binary = (param == "binary");
+                else
+                    throw std::invalid_argument("unknown format " + param);
+            } else if ((arg.size() > 1) && (arg[0] == '-')
+                       && !std::isdigit(static_cast<unsigned char>(arg[1]))) {
+                throw std::invalid_argument("unknown option " + arg);
+            } else {
+                ret.args.push_back(argv[i]);
+            }
+        }
+
+        if (!ret.coordinator.empty()) {
+            if (!ret.args.empty() || (ret.port >= 0) || ret.binary
+                || (ret.output != nullptr) || (ret.checkpoint != nullptr)
+                || ret.summary || (ret.records != 0) || ret.all
+                || ret.glide || (ret.sieve != nullptr)
+                || (ret.stops != nullptr) || !ret.engine.empty()
+                || (ret.metrics != nullptr) || (ret.store != nullptr)) {
+                throw std::invalid_argument("-w can only be used with -b");
+            }
+
+            return ret;
+        }
+
+        if ((ret.args.size() < 2) || (ret.args.size() > 4))
+            throw std::invalid_argument("wrong number of arguments");
+
+        if (ret.port >= 0) {
+            if (ret.port > 65535)
+                throw std::invalid_argument("invalid port "
+                                            + std::to_string(ret.port));
+
+            if (ret.output == nullptr)
+                throw std::invalid_argument("-l needs -o");
+
+            if (ret.binary || (ret.checkpoint != nullptr) || ret.summary
+                || (ret.records != 0) || ret.glide || !ret.engine.empty()
+                || (ret.stops != nullptr) || (ret.metrics != nullptr)
+                || (ret.store != nullptr)) {
+                throw std::invalid_argument("-l cannot be used with -f, -c, "
+                                            "-s, -t, -g, -e, -T, -m or -r");
+            }
+        }
+
+        if ((ret.records != 0)
+            && (ret.binary || (ret.checkpoint != nullptr) || ret.summary)) {
+            throw std::invalid_argument("-t cannot be used with -f, -c or "
+                                        "-s");
+        }
+
+        if (ret.all && (ret.records == 0))
+            throw std::invalid_argument("-a needs -t");
+
+        if (ret.glide
+            && (ret.binary || (ret.checkpoint != nullptr) || ret.summary
+                || (ret.records != 0) || (ret.args.size() != 2))) {
+            throw std::invalid_argument("-g cannot be used with -f, -c, -s, "
+                                        "-t, VALUE or STEP");
+        }
+
+        if (!ret.engine.empty() && ((ret.records != 0) || ret.glide))
+            throw std::invalid_argument("-e cannot be used with -t or -g");
+
+        if ((ret.store != nullptr)
+            && ((ret.checkpoint != nullptr) || (ret.records != 0)
+                || ret.glide)) {
+            throw std::invalid_argument("-r cannot be used with -c, -t or "
+                                        "-g");
+        }
+
+        if ((ret.metrics != nullptr) && !core::Metrics::enabled)
+            throw std::invalid_argument("-m needs a build configured "
+                                        "WITH_METRICS");
+
+        if ((ret.checkpoint != nullptr) && !ret.summary
+            && (ret.output == nullptr)) {
+            throw std::invalid_argument("-c needs -o, unless with -s");
+        }
+
+        if ((ret.sieve != nullptr) && !ret.glide)
+            throw std::invalid_argument("-S needs -g");
+
+        if ((ret.stops != nullptr)
+            && (ret.glide
+                || ((ret.args.size() > 2) && (std::stoll(ret.args[2]) != 1)))) {
+            throw std::invalid_argument("-T cannot be used with -g, and "
+                                        "needs a VALUE of 1");
+        }
+
+        if (ret.binary && (ret.output == nullptr))
+            throw std::invalid_argument("the binary format needs -o");
+
+        if (ret.binary && ((ret.checkpoint != nullptr) || ret.summary)) {
+            throw std::invalid_argument("the binary format cannot be used "
+                                        "with -c or -s");
+        }
+
+        return ret;
+    }
+
+    void work(const Options& opts)
+    {
+        const std::size_t colon = opts.coordinator.rfind(':');
+
+        if ((colon == std::string::npos) || (colon == 0))
+            throw std::invalid_argument("-w needs HOST:PORT");
+
+        const unsigned long port =
+            std::stoul(opts.coordinator.substr(colon + 1));
+
+        if (port > 65535)
+            throw std::invalid_argument("invalid port " + std::to_string(port));
+
+        core::Socket socket =
+            core::Socket::connect(opts.coordinator.substr(0, colon),
+                                  static_cast<uint16_t>(port));
+        sequence::Worker(opts.blockSize).run(socket);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::FILE* file = stdout;
+
+    try {
+        const Options opts = parse(argc, argv);
+
+        if (!opts.coordinator.empty()) {
+            work(opts);
+            return EXIT_SUCCESS;
+        }
+
+        const int64_t first = std::stoll(opts.args[0]);
+        const uint64_t count = std::stoull(opts.args[1]);
+        const int64_t value = (opts.args.size() > 2) ? std::stoll(opts.args[2])
+                                                     : 1;
+        const int64_t step = (opts.args.size() > 3) ? std::stoll(opts.args[3])
+                                                    : 1;
+
+        if (opts.port >= 0) {
+            core::Socket listener =
+                core::Socket::listen(static_cast<uint16_t>(opts.port));
+
+            sequence::Coordinator(opts.output, { first }, value, step, count,
+                                  (opts.chunkSize != 0)
+                                      ? opts.chunkSize
+                                      : sequence::Coordinator::defaultChunkSize)
+                .withLog([&](const std::string& message) {
+                    std::cerr << argv[0] << ": " << message << '\n';
+                })
+                .serve(listener);
+
+            return EXIT_SUCCESS;
+        }
+
+        const auto maxCount = [&]() {
+            return static_cast<uint64_t>(std::numeric_limits<int64_t>::max()
+                                         - first);
+        };
+
+        if ((opts.records != 0)
+            && ((step != 1) || (first <= 0) || (count > maxCount()))) {
+            throw std::invalid_argument("-t needs a STEP of 1 and strictly "
+                                        "positive initial terms fitting in "
+                                        "64 bits");
+        }
+
+        if (opts.glide && ((first <= 1) || (count > maxCount()))) {
+            throw std::invalid_argument("-g needs initial terms greater "
+                                        "than 1 fitting in 64 bits");
+        }
+
+        if ((opts.output != nullptr)
+            && ((file = std::fopen(opts.output, mode(opts))) == nullptr)) {
+            std::cerr << argv[0] << ": " << opts.output << ": "
+                      << std::strerror(errno) << '\n';
+            return EXIT_FAILURE;
+        }
+
+        sequence::CollatzSequence seq(first);
+        seq.withJumpTable(std::make_shared<sequence::JumpTable>());
+        const auto cache = std::make_shared<sequence::ResultCache>(value,
+                                                                   1 << 20);
+        seq.withCache(cache);
+
+        if (opts.stops != nullptr)
+            seq.withStoppingTable(stoppingTable(opts.stops));
+
+        sequence::Sweep sweep(seq, value, step);
+        sweep.withBlockSize(opts.blockSize);
+
+        if (!opts.engine.empty())
+            sweep.withEngine(sequence::Engine::make(opts.engine));
+
+        // The runs kept in the store also warm the cache up.
+        std::unique_ptr<sequence::SweepStore> store;
+
+        if (opts.store != nullptr) {
+            store = std::make_unique<sequence::SweepStore>(opts.store,
+                                                           "collatz");
+            store->withBlockSize(opts.blockSize).withEngine(sweep.engine());
+            store->warm(*cache);
+        }
+
+        const auto run = [&](const sequence::Sweep::sink_t& sink) {
+            if (store)
+                store->run(seq, count, value, step, sink);
+            else
+                sweep.run(count, sink);
+        };
+
+        Ref<sequence::Checkpoint> checkpoint;
+
+        if (opts.checkpoint != nullptr) {
+            checkpoint = std::make_shared<sequence::Checkpoint>(opts.checkpoint);
+            sweep.withCheckpoint(checkpoint);
+        }
+
+        // The metrics are rewritten at most once per second while the
+        // sweep runs, and once more at the end.
+        auto saved = std::chrono::steady_clock::now();
+        const auto save = [&](const bool force) {
+            const auto now = std::chrono::steady_clock::now();
+
+            if ((opts.metrics != nullptr)
+                && (force || (now - saved >= std::chrono::seconds(1)))) {
+                core::Metrics::global().save(opts.metrics);
+                saved = now;
+            }
+        };
+
+        if (opts.glide) {
+            write(file, sequence::ConvergenceCheck(sieve(opts.sieve))
+                            .run(first, first + static_cast<int64_t>(count)),
+                  first);
+        } else if (opts.records != 0) {
+            write(file, sequence::RecordFinder(seq, value)
+                            .withCount(opts.records)
+                            .withSieve(!opts.all)
+                            .find(first, first + static_cast<int64_t>(count)));
+        } else if (opts.summary) {
+            sequence::Summary summary;
+            uint64_t ordinal = 0;
+
+            run([&](const sequence::ResultTable& block) {
+                for (std::size_t i = 0; i < block.size(); ++i) {
+                    summary.add(ordinal++, { block.cycleLen(i),
+                                             block.wideMaxTerm(i) });
+                }
+
+                save(false);
+            });
+
+            // The checkpoint also holds the runs done before resuming.
+            if (checkpoint)
+                summary = checkpoint->summary();
+
+            write(file, summary, first, step);
+        } else if (opts.binary) {
+            sequence::BinaryWriter writer(file, value);
+            run([&](const sequence::ResultTable& block) {
+                writer.write(block);
+                save(false);
+            });
+            writer.close();
+        } else {
+            sequence::TextWriter writer(file);
+
+            // The output is cut back to the last checkpoint on resuming, so
+            // that the blocks run again are not written twice.
+            if (checkpoint) {
+                checkpoint->withOutput(
+                    [&] {
+                        writer.flush();
+                        struct stat st;
+
+                        if ((::fsync(::fileno(file)) != 0)
+                            || (::fstat(::fileno(file), &st) != 0)) {
+                            throw std::runtime_error(opts.output
+                                                     + std::string(": ")
+                                                     + std::strerror(errno));
+                        }
+
+                        return static_cast<uint64_t>(st.st_size);
+                    },
+                    [&](const uint64_t mark) {
+                        struct stat st;
+
+                        if (::fstat(::fileno(file), &st) != 0)
+                            throw std::runtime_error(std::strerror(errno));
+
+                        if (static_cast<uint64_t>(st.st_size) < mark) {
+                            throw std::runtime_error(
+                                opts.output + std::string(": The output is "
+                                                          "shorter than "
+                                                          "recorded by the "
+                                                          "checkpoint."));
+                        }
+
+                        if (::ftruncate(::fileno(file),
+                                        static_cast<off_t>(mark)) != 0) {
+                            throw std::runtime_error(opts.output
+                                                     + std::string(": ")
+                                                     + std::strerror(errno));
+                        }
+                    });
+            }
+
+            run([&](const sequence::ResultTable& block) {
+                writer.write(block);
+                save(false);
+            });
+            writer.flush();
+        }
+
+        save(true);
+    } catch (const std::logic_error& e) {
+        std::cerr << argv[0] << ": " << e.what() << '\n';
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    } catch (const std::exception& e) {
+        std::cerr << argv[0] << ": " << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    if ((file != stdout) && (std::fclose(file) != 0)) {
+        std::cerr << argv[0] << ": " << std::strerror(errno) << '\n';
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
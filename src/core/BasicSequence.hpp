@@ -0,0 +1,302 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_BASIC_SEQUENCE_HPP
+#define SYRACUSE_BASIC_SEQUENCE_HPP
+
+#include "core/Sequence.hpp"
+
+#include <array>
+
+namespace sequence
+{
+    /**
+     * @class BasicSequence core/BasicSequence.hpp core/BasicSequence.hpp
+     * @brief A sequence whose order and recurrence relation are known at
+     * compile time.
+     *
+     * Unlike \p Sequence, the recurrence relation is not type-erased and the
+     * last terms are kept in an `std::array`, so that the compiler can
+     * inline the relation into the evaluation loop.
+     *
+     * The relation takes the window of the last \p Order terms, the most
+     * recent one coming first, as for \p Sequence::seq_t.
+     *
+     * @par Example
+     * The code below corresponds to the Fibonacci sequence:
+     *
+     * ```cpp
+     * auto fibonacci = sequence::makeSequence<2>(
+     *     [](const std::array<int64_t, 2>& un_) {
+     *         return un_[1] + un_[0];
+     *     });
+     *
+     * fibonacci.at(6, {{0, 1}}); // returns 8
+     * ```
+     *
+     * @tparam Order    the number of terms used by the recurrence relation
+     * @tparam Relation the type of the recurrence relation
+     * @tparam Int      the type of the terms
+     */
+    template<std::size_t Order, typename Relation, typename Int = int64_t>
+    class BasicSequence
+    {
+        static_assert(Order > 0, "A recurrence relation needs at least one "
+                                 "term.");
+    public:
+        /**
+         * @brief Type representing the window of the last terms.
+         */
+        using window_t = std::array<Int, Order>;
+        /**
+         * @brief Type representing the rank of a term.
+         */
+        using size_type = Sequence::vec_t::size_type;
+        /**
+         * @brief Type containing the result of the `doUntil()` methods.
+         */
+        using Result = BasicResult<Int>;
+
+        /**
+         * @class Cursor core/BasicSequence.hpp
+         * @brief A cursor stepping through the terms of a sequence.
+         *
+         * @see Sequence::Cursor
+         */
+        class Cursor
+        {
+        public:
+            /**
+             * @brief Construct a cursor pointing to the first term.
+             *
+             * @param uz  the initial terms
+             * @param rel the recurrence relation
+             */
+            constexpr Cursor(const window_t& uz, const Relation& rel);
+
+            /**
+             * @brief Get the term of the current rank.
+             *
+             * @return the current term
+             */
+            constexpr Int operator*() const { return m_window[m_offset]; }
+            /**
+             * @brief Move to the next rank.
+             *
+             * @return a reference to the current object
+             */
+            constexpr Cursor& operator++();
+            /**
+             * @brief Move \p n ranks forward.
+             *
+             * @param n the number of ranks to skip
+             * @return  a reference to the current object
+             */
+            constexpr Cursor& advance(const size_type n);
+
+            /**
+             * @brief Get the current rank.
+             *
+             * @return the current rank
+             */
+            constexpr size_type rank() const { return m_rank; }
+            /**
+             * @brief Get the window of the last terms.
+             *
+             * @return the window of the last terms
+             */
+            constexpr const window_t& window() const { return m_window; }
+        private:
+            window_t m_window;
+            const Relation* m_rel;
+            size_type m_rank;
+            size_type m_offset;
+        };
+    public:
+        /**
+         * @brief Construct an object from a recurrence relation and set the
+         * initial terms.
+         *
+         * @param uz  the initial terms
+         * @param rel the recurrence relation
+         */
+        constexpr BasicSequence(const window_t& uz, const Relation& rel)
+            : m_uz(uz), m_rel(rel) {}
+        /**
+         * @brief Construct an object from a recurrence relation without
+         * setting the initial terms.
+         *
+         * All the initial terms are then equal to zero.
+         *
+         * @param rel the recurrence relation
+         */
+        constexpr BasicSequence(const Relation& rel = Relation())
+            : BasicSequence({}, rel) {}
+
+        /**
+         * @brief Set the initial terms to the current object.
+         *
+         * @param uz the initial terms
+         * @return   a reference to the modified object
+         */
+        constexpr BasicSequence& withUz(const window_t& uz)
+        {
+            m_uz = uz;
+            return *this;
+        }
+
+        /**
+         * @brief Get a cursor pointing to the first term with the given
+         * initial terms.
+         *
+         * @param uz the initial terms
+         * @return   a cursor pointing to \f$u_0\f$
+         */
+        constexpr Cursor cursor(const window_t& uz) const
+        {
+            return Cursor(uz, m_rel);
+        }
+        /**
+         * @brief Get a cursor pointing to the first term.
+         *
+         * @return a cursor pointing to \f$u_0\f$
+         */
+        constexpr Cursor cursor() const { return cursor(m_uz); }
+
+        /**
+         * @brief Get the term of the corresponding rank with the given
+         * initial terms.
+         *
+         * @param n  the corresponding rank
+         * @param uz the initial terms
+         * @return   the nth term
+         */
+        constexpr Int at(const size_type n, const window_t& uz) const
+        {
+            return *cursor(uz).advance(n);
+        }
+        /**
+         * @brief Get the term of the corresponding rank.
+         *
+         * @param n the corresponding rank
+         * @return  the nth term
+         */
+        constexpr Int at(const size_type n) const { return at(n, m_uz); }
+        /**
+         * @brief Run the sequence until some value with the given initial
+         * terms.
+         *
+         * @param value run the sequence until
+         * @param uz    the initial terms
+         * @return      some statistics
+         */
+        constexpr Result doUntil(const Int value, const window_t& uz) const;
+        /**
+         * @brief Run the sequence until some value.
+         *
+         * @param value run the sequence until
+         * @return      some statistics
+         */
+        constexpr Result doUntil(const Int value) const
+        {
+            return doUntil(value, m_uz);
+        }
+    private:
+        window_t m_uz;
+        Relation m_rel;
+    };
+
+    /**
+     * @brief Create a \p BasicSequence object deducing the type of the
+     * recurrence relation.
+     *
+     * This is especially useful for lambdas, whose type cannot be named.
+     *
+     * @tparam Order    the number of terms used by the recurrence relation
+     * @tparam Int      the type of the terms
+     * @tparam Relation the type of the recurrence relation
+     *
+     * @param rel the recurrence relation
+     * @return    the created sequence
+     */
+    template<std::size_t Order, typename Int = int64_t, typename Relation>
+    constexpr BasicSequence<Order, Relation, Int>
+    makeSequence(const Relation& rel)
+    {
+        return BasicSequence<Order, Relation, Int>(rel);
+    }
+
+    template<std::size_t Order, typename Relation, typename Int>
+    constexpr BasicSequence<Order, Relation, Int>::Cursor::Cursor(
+        const window_t& uz, const Relation& rel)
+        : m_window()
+        , m_rel(&rel)
+        , m_rank(0)
+        , m_offset(Order - 1)
+    {
+        for (size_type i = 0; i < Order; ++i)
+            m_window[i] = uz[Order - 1 - i];
+    }
+
+    template<std::size_t Order, typename Relation, typename Int>
+    constexpr typename BasicSequence<Order, Relation, Int>::Cursor&
+    BasicSequence<Order, Relation, Int>::Cursor::operator++()
+    {
+        if (m_offset > 0) {
+            --m_offset;
+        } else {
+            const Int term = (*m_rel)(m_window);
+
+            for (size_type i = Order - 1; i > 0; --i)
+                m_window[i] = m_window[i - 1];
+
+            m_window[0] = term;
+        }
+
+        ++m_rank;
+        return *this;
+    }
+
+    template<std::size_t Order, typename Relation, typename Int>
+    constexpr typename BasicSequence<Order, Relation, Int>::Cursor&
+    BasicSequence<Order, Relation, Int>::Cursor::advance(const size_type n)
+    {
+        for (size_type i = 0; i < n; ++i)
+            ++*this;
+
+        return *this;
+    }
+
+    template<std::size_t Order, typename Relation, typename Int>
+    constexpr typename BasicSequence<Order, Relation, Int>::Result
+    BasicSequence<Order, Relation, Int>::doUntil(const Int value,
+                                                 const window_t& uz) const
+    {
+        auto c = cursor(uz);
+        Int maxTerm = *c;
+
+        for (; *c != value; ++c) {
+            if (*c > maxTerm)
+                maxTerm = *c;
+        }
+
+        return { c.rank(), maxTerm };
+    }
+}
+
+#endif // SYRACUSE_BASIC_SEQUENCE_HPP
@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/BinaryWriter.hpp"
+
+#include "core/ResultFile.hpp"
+#include "core/ResultTable.hpp"
+#include "core/Varint.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+namespace sequence
+{
+    namespace
+    {
+        std::runtime_error error(const char* where)
+        {
+            return std::runtime_error(std::string(where) + ": "
+                                      + std::strerror(errno));
+        }
+    }
+
+    BinaryWriter::BinaryWriter(std::FILE* file, const int64_t value,
+                               const uint32_t blockSize)
+        : m_file(file)
+        , m_value(value)
+        , m_blockSize(std::max<uint32_t>(blockSize, 1))
+        , m_uz()
+        , m_step(0)
+        , m_size(0)
+        , m_offset(0)
+        , m_index()
+        , m_cycleLens()
+        , m_maxTerms()
+        , m_closed(false)
+    {
+        // The offsets of the blocks are the ones read by ResultFile, which
+        // finds the header at the start of the file.
+        const long start = std::ftell(file);
+
+        if (start < 0)
+            throw error("BinaryWriter::BinaryWriter()");
+
+        if (start != 0) {
+            throw std::invalid_argument("BinaryWriter::BinaryWriter(): The "
+                                        "file must be at its start.");
+        }
+    }
+
+    BinaryWriter::~BinaryWriter()
+    {
+        try {
+            close();
+        } catch (...) {}
+    }
+
+    void BinaryWriter::write(const ResultTable& table)
+    {
+        if (m_closed) {
+            throw std::invalid_argument("BinaryWriter::write(): The writer "
+                                        "is closed.");
+        }
+
+        if (table.size() == 0)
+            return;
+
+        if (m_uz.empty()) {
+            // The header is written now so that the blocks can follow it,
+            // and completed by close().
+            m_uz = table.uz();
+            m_step = table.step();
+            put(header(0));
+        } else {
+            Sequence::vec_t next = m_uz;
+            for (auto& i : next)
+                i += static_cast<int64_t>(m_size) * m_step;
+
+            if ((table.step() != m_step) || (table.uz() != next)) {
+                throw std::invalid_argument("BinaryWriter::write(): The table "
+                                            "does not follow the written "
+                                            "runs.");
+            }
+        }
+
+        for (std::size_t i = 0; i < table.size(); ++i) {
+            m_cycleLens.push_back(table.cycleLen(i));
+            m_maxTerms.push_back(table.wideMaxTerm(i));
+            ++m_size;
+
+            if (m_cycleLens.size() == m_blockSize)
+                writeBlock();
+        }
+    }
+
+    void BinaryWriter::close()
+    {
+        if (m_closed)
+            return;
+
+        m_closed = true;
+
+        if (m_uz.empty()) {
+            m_uz = { 0 };
+            put(header(0));
+        }
+
+        writeBlock();
+
+        std::vector<unsigned char> index;
+        for (const auto i : m_index)
+            core::varint::putFixed(index, i);
+
+        const uint64_t indexOffset = m_offset;
+        put(index);
+
+        // The header is completed now that the number of runs and the
+        // place of the index are known.
+        const auto bytes = header(indexOffset);
+
+        if ((std::fseek(m_file, 0, SEEK_SET) != 0)
+            || (std::fwrite(bytes.data(), 1, bytes.size(), m_file)
+                != bytes.size())
+            || (std::fseek(m_file, 0, SEEK_END) != 0)
+            || (std::fflush(m_file) != 0)) {
+            throw error("BinaryWriter::close()");
+        }
+    }
+
+    std::vector<unsigned char>
+    BinaryWriter::header(const uint64_t indexOffset) const
+    {
+        using core::varint::putFixed;
+
+        std::vector<unsigned char> ret(ResultFile::magic,
+                                       ResultFile::magic + 8);
+
+        putFixed(ret, ResultFile::version);
+        putFixed(ret, static_cast<uint32_t>(m_uz.size()));
+        putFixed(ret, m_value);
+        putFixed(ret, m_step);
+        putFixed(ret, m_size);
+        putFixed(ret, m_blockSize);
+        putFixed(ret, uint32_t(0));
+        putFixed(ret, indexOffset);
+        ret.resize(ResultFile::headerSize, 0);
+
+        for (const auto i : m_uz)
+            putFixed(ret, i);
+
+        return ret;
+    }
+
+    void BinaryWriter::writeBlock()
+    {
+        using core::varint::zigzag;
+
+        if (m_cycleLens.empty())
+            return;
+
+        std::vector<unsigned char> cycles;
+        std::vector<unsigned char> terms;
+        std::size_t cycleLen = 0;
+        int64_t uz = m_uz.front()
+                     + static_cast<int64_t>(m_size - m_cycleLens.size())
+                       * m_step;
+
+        for (std::size_t i = 0; i < m_cycleLens.size(); ++i) {
+            const auto delta = static_cast<int128_t>(m_cycleLens[i])
+                               - static_cast<int128_t>(cycleLen);
+
+            core::varint::put(cycles, zigzag(delta));
+            core::varint::put(terms, zigzag(m_maxTerms[i] - uz));
+
+            cycleLen = m_cycleLens[i];
+            uz += m_step;
+        }
+
+        m_index.push_back(m_offset);
+        m_index.push_back(m_offset + cycles.size());
+
+        put(cycles);
+        put(terms);
+
+        m_cycleLens.clear();
+        m_maxTerms.clear();
+    }
+
+    void BinaryWriter::put(const std::vector<unsigned char>& bytes)
+    {
+        if (std::fwrite(bytes.data(), 1, bytes.size(), m_file) != bytes.size())
+            throw error("BinaryWriter::put()");
+
+        m_offset += bytes.size();
+    }
+}
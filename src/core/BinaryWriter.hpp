@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_BINARY_WRITER_HPP
+#define SYRACUSE_BINARY_WRITER_HPP
+
+#include "core/Sequence.hpp"
+
+#include <cstdio>
+
+namespace sequence
+{
+    class ResultTable;
+
+    /**
+     * @class BinaryWriter core/BinaryWriter.hpp core/BinaryWriter.hpp
+     * @brief A writer of results in the binary format of `ResultFile`.
+     *
+     * The runs are gathered into blocks, each one being compressed and
+     * written once full. The header and the block index are written by
+     * `close()`, so that the file must be seekable. The offsets of the blocks
+     * are the ones of the file, which must thus be written from its start.
+     *
+     * @par Example
+     *
+     * ```cpp
+     * std::FILE* file = std::fopen("sweep.bin", "wb");
+     * sequence::BinaryWriter writer(file, 1);
+     *
+     * sequence::Sweep(mySeq, 1).run(1000000,
+     *     [&](const sequence::ResultTable& block) { writer.write(block); });
+     *
+     * writer.close();
+     * std::fclose(file);
+     * ```
+     */
+    class BinaryWriter
+    {
+    public:
+        /**
+         * @brief Type representing the ordinal of a run.
+         */
+        using size_type = uint64_t;
+    public:
+        /**
+         * @brief Construct a writer.
+         *
+         * The file is not closed by the writer.
+         *
+         * @exception std::invalid_argument if the file is not at its start
+         * @exception std::runtime_error if the file cannot be written
+         *
+         * @param file      the seekable file to write to, at its start
+         * @param value     the target value of the runs
+         * @param blockSize the number of runs per block
+         */
+        BinaryWriter(std::FILE* file, const int64_t value,
+                     const uint32_t blockSize = defaultBlockSize);
+        BinaryWriter(const BinaryWriter&) = delete;
+        BinaryWriter& operator=(const BinaryWriter&) = delete;
+        /**
+         * @brief Close the writer if needed, ignoring the errors.
+         */
+        ~BinaryWriter();
+
+        /**
+         * @brief Get the number of runs written.
+         *
+         * @return the number of runs
+         */
+        size_type size() const { return m_size; }
+
+        /**
+         * @brief Write the runs of a table.
+         *
+         * The initial terms of the first run of each table must follow the
+         * ones of the last run written, with the same step.
+         *
+         * @exception std::invalid_argument if the table does not follow
+         * the written runs
+         * @exception std::runtime_error if the file cannot be written
+         *
+         * @param table the table to write
+         */
+        void write(const ResultTable& table);
+        /**
+         * @brief Write the last block, the block index and the header.
+         *
+         * Nothing can be written afterwards.
+         *
+         * @exception std::runtime_error if the file cannot be written
+         */
+        void close();
+    public:
+        /**
+         * @brief The number of runs per block used by default.
+         */
+        static constexpr uint32_t defaultBlockSize = 4096;
+    private:
+        std::vector<unsigned char> header(const uint64_t indexOffset) const;
+        void writeBlock();
+        void put(const std::vector<unsigned char>& bytes);
+    private:
+        std::FILE* m_file;
+        int64_t m_value;
+        uint32_t m_blockSize;
+        Sequence::vec_t m_uz;
+        int64_t m_step;
+        size_type m_size;
+        uint64_t m_offset;
+        std::vector<uint64_t> m_index;
+        std::vector<std::size_t> m_cycleLens;
+        std::vector<int128_t> m_maxTerms;
+        bool m_closed;
+    };
+}
+
+#endif // SYRACUSE_BINARY_WRITER_HPP
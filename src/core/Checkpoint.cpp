@@ -0,0 +1,439 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/Checkpoint.hpp"
+
+#include "core/ReplaceFile.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace sequence
+{
+    namespace
+    {
+        constexpr const char* magic = "syracuse-checkpoint";
+        constexpr int version = 2;
+
+        int128_t parseWide(const std::string& s)
+        {
+            std::size_t i = ((s.size() > 1) && (s[0] == '-')) ? 1 : 0;
+            int128_t ret = 0;
+
+            if (i == s.size())
+                throw std::runtime_error("Checkpoint: Malformed integer.");
+
+            for (; i < s.size(); ++i) {
+                if ((s[i] < '0') || (s[i] > '9'))
+                    throw std::runtime_error("Checkpoint: Malformed integer.");
+
+                ret = ret * 10 + (s[i] - '0');
+            }
+
+            return (s[0] == '-') ? -ret : ret;
+        }
+
+        // Inserts [block, block + 1) into a set of disjoint ranges, merging
+        // it with its neighbours.
+        void insert(std::map<uint64_t, uint64_t>& ranges, const uint64_t block)
+        {
+            auto next = ranges.upper_bound(block);
+
+            if (next != ranges.begin()) {
+                auto prev = std::prev(next);
+
+                if (prev->second > block)
+                    return;
+
+                if (prev->second == block) {
+                    prev->second = block + 1;
+
+                    if ((next != ranges.end()) && (next->first == block + 1)) {
+                        prev->second = next->second;
+                        ranges.erase(next);
+                    }
+
+                    return;
+                }
+            }
+
+            if ((next != ranges.end()) && (next->first == block + 1)) {
+                const uint64_t end = next->second;
+                ranges.erase(next);
+                ranges.emplace(block, end);
+            } else {
+                ranges.emplace(block, block + 1);
+            }
+        }
+
+        uint64_t count(const std::map<uint64_t, uint64_t>& ranges)
+        {
+            uint64_t ret = 0;
+
+            for (const auto& i : ranges)
+                ret += i.second - i.first;
+
+            return ret;
+        }
+    }
+
+    Checkpoint::Checkpoint(const std::string& path, const duration_t interval)
+        : m_path(path)
+        , m_interval(interval)
+        , m_uz()
+        , m_value(0)
+        , m_step(0)
+        , m_runs(0)
+        , m_blockSize(0)
+        , m_sync()
+        , m_rewind()
+        , m_outputMutex()
+        , m_resumed()
+        , m_pushed(nullptr)
+        , m_mutex()
+        , m_done()
+        , m_summary()
+        , m_mark(0)
+        , m_cond()
+        , m_flusher()
+        , m_error()
+        , m_open(false)
+        , m_stop(false)
+    {}
+
+    Checkpoint::~Checkpoint()
+    {
+        try {
+            close();
+        } catch (...) {}
+
+        drain();
+    }
+
+    Checkpoint& Checkpoint::withOutput(const sync_t& sync,
+                                       const rewind_t& rewind)
+    {
+        m_sync = sync;
+        m_rewind = rewind;
+        return *this;
+    }
+
+    void Checkpoint::open(const Sequence::vec_t& uz, const int64_t value,
+                          const int64_t step, const uint64_t runs,
+                          const uint64_t blockSize)
+    {
+        if (m_open) {
+            throw std::invalid_argument("Checkpoint::open(): The checkpoint "
+                                        "is already open.");
+        }
+
+        m_uz = uz;
+        m_value = value;
+        m_step = step;
+        m_runs = runs;
+        m_blockSize = blockSize;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_done.clear();
+            m_summary = Summary();
+            m_mark = 0;
+            m_error = nullptr;
+            m_stop = false;
+        }
+
+        // The results written after the last save belong to blocks that
+        // are run again.
+        if (load()) {
+            if (m_rewind)
+                m_rewind(m_mark);
+        } else {
+            sync();
+            save(serialize());
+        }
+
+        m_resumed = m_done;
+
+        m_open = true;
+        m_flusher = std::thread(&Checkpoint::flush, this);
+    }
+
+    bool Checkpoint::isDone(const size_type block) const
+    {
+        const auto it = m_resumed.upper_bound(block);
+        return (it != m_resumed.begin()) && (std::prev(it)->second > block);
+    }
+
+    void Checkpoint::complete(const size_type block, const Summary& summary,
+                              const write_t& write)
+    {
+        std::unique_lock<std::mutex> lock(m_outputMutex, std::defer_lock);
+
+        if (write) {
+            lock.lock();
+            write();
+        }
+
+        Node* node = new Node{ block, summary, m_pushed.load() };
+
+        while (!m_pushed.compare_exchange_weak(node->next, node,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed)) {}
+    }
+
+    void Checkpoint::close()
+    {
+        if (!m_open)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+
+        m_cond.notify_all();
+        m_flusher.join();
+        m_open = false;
+
+        std::exception_ptr error;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::swap(error, m_error);
+        }
+
+        // The last blocks pushed are merged now that the flusher is done.
+        std::string data;
+
+        {
+            std::lock_guard<std::mutex> lock(m_outputMutex);
+            sync();
+            drain();
+            data = serialize();
+        }
+
+        save(data);
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    Checkpoint::size_type Checkpoint::doneBlocks()
+    {
+        drain();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return count(m_done);
+    }
+
+    Summary Checkpoint::summary()
+    {
+        drain();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_summary;
+    }
+
+    bool Checkpoint::load()
+    {
+        std::ifstream in(m_path);
+
+        if (!in) {
+            if (errno == ENOENT)
+                return false;
+
+            throw std::runtime_error("Checkpoint::load(): " + m_path + ": "
+                                     + std::strerror(errno));
+        }
+
+        const auto malformed = [&] {
+            return std::runtime_error("Checkpoint::load(): " + m_path
+                                      + ": Malformed checkpoint.");
+        };
+
+        std::string key;
+        int fileVersion = 0;
+        std::size_t order = 0;
+
+        if (!(in >> key >> fileVersion) || (key != magic)
+            || (fileVersion != version) || !(in >> key >> order)
+            || (key != "uz")) {
+            throw malformed();
+        }
+
+        Sequence::vec_t uz(order);
+        for (auto& i : uz)
+            in >> i;
+
+        int64_t value, step;
+        uint64_t runs, blockSize, mark;
+        std::string highest;
+        Summary summary;
+        std::size_t ranges = 0;
+
+        if (!(in >> key >> value) || (key != "value")
+            || !(in >> key >> step) || (key != "step")
+            || !(in >> key >> runs) || (key != "runs")
+            || !(in >> key >> blockSize) || (key != "blockSize")
+            || !(in >> key >> mark) || (key != "mark")
+            || !(in >> key >> summary.runs >> summary.totalCycleLen
+                 >> summary.longestCycleLen >> summary.longestRun >> highest
+                 >> summary.highestRun)
+            || (key != "summary") || !(in >> key >> ranges)
+            || (key != "ranges")) {
+            throw malformed();
+        }
+
+        summary.highestMaxTerm = parseWide(highest);
+
+        if ((uz != m_uz) || (value != m_value) || (step != m_step)
+            || (runs != m_runs) || (blockSize != m_blockSize)) {
+            throw std::invalid_argument("Checkpoint::load(): " + m_path
+                                        + ": The checkpoint belongs to "
+                                          "another sweep.");
+        }
+
+        std::map<size_type, size_type> done;
+
+        for (std::size_t i = 0; i < ranges; ++i) {
+            size_type begin, end;
+
+            if (!(in >> begin >> end) || (begin >= end))
+                throw malformed();
+
+            done.emplace(begin, end);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_done = std::move(done);
+        m_summary = summary;
+        m_mark = mark;
+        return true;
+    }
+
+    std::string Checkpoint::serialize() const
+    {
+        std::ostringstream out;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            out << magic << ' ' << version << "\nuz " << m_uz.size();
+            for (const auto i : m_uz)
+                out << ' ' << i;
+
+            out << "\nvalue " << m_value << "\nstep " << m_step
+                << "\nruns " << m_runs << "\nblockSize " << m_blockSize
+                << "\nmark " << m_mark
+                << "\nsummary " << m_summary.runs << ' '
+                << m_summary.totalCycleLen << ' '
+                << m_summary.longestCycleLen << ' ' << m_summary.longestRun
+                << ' ' << toString(m_summary.highestMaxTerm) << ' '
+                << m_summary.highestRun << "\nranges " << m_done.size()
+                << '\n';
+
+            for (const auto& i : m_done)
+                out << i.first << ' ' << i.second << '\n';
+        }
+
+        return out.str();
+    }
+
+    void Checkpoint::save(const std::string& data) const
+    {
+        // The file is replaced at once, so that an interruption leaves the
+        // previous checkpoint intact.
+        core::replaceFile(m_path, { { data.data(), data.size() } },
+                          "Checkpoint::save()");
+    }
+
+    void Checkpoint::sync()
+    {
+        if (!m_sync)
+            return;
+
+        const uint64_t mark = m_sync();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_mark = mark;
+    }
+
+    bool Checkpoint::drain()
+    {
+        Node* node = m_pushed.exchange(nullptr, std::memory_order_acquire);
+
+        if (node == nullptr)
+            return false;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        while (node != nullptr) {
+            Node* const next = node->next;
+
+            insert(m_done, node->block);
+            m_summary.merge(node->summary);
+            delete node;
+
+            node = next;
+        }
+
+        return true;
+    }
+
+    void Checkpoint::flush()
+    {
+        for (;;) {
+            bool stop;
+
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cond.wait_for(lock, m_interval, [this] { return m_stop; });
+                stop = m_stop;
+            }
+
+            if (stop)
+                return;
+
+            // The output is synced before the blocks are taken, and no block
+            // is completed until they are serialized, so that the saved
+            // position covers the results of all the saved blocks.
+            try {
+                std::string data;
+
+                {
+                    std::lock_guard<std::mutex> lock(m_outputMutex);
+                    sync();
+
+                    if (drain())
+                        data = serialize();
+                }
+
+                if (!data.empty())
+                    save(data);
+            } catch (...) {
+                // Reported by close(), the progress being saved again on
+                // the next write.
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                if (!m_error)
+                    m_error = std::current_exception();
+            }
+        }
+    }
+}
@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_CHECKPOINT_HPP
+#define SYRACUSE_CHECKPOINT_HPP
+
+#include "core/Summary.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace sequence
+{
+    /**
+     * @class Checkpoint core/Checkpoint.hpp core/Checkpoint.hpp
+     * @brief The progress of a `Sweep`, saved periodically to a file.
+     *
+     * The file records the parameters of the sweep, the ranges of the
+     * blocks done and the `Summary` of their runs. A sweep given a
+     * checkpoint whose file exists resumes it: the blocks already done are
+     * neither run again nor given to the sink.
+     *
+     * A block is only recorded as done once its results have been given
+     * to the sink, and is then pushed onto a lock-free stack. A background
+     * thread merges the pushed blocks and rewrites the file every
+     * `interval()`, through a temporary file renamed afterwards so that the
+     * file is never left half-written.
+     *
+     * A sink writing the results to a file gives it to the checkpoint
+     * through `withOutput()`. Before each write of the checkpoint, the
+     * output is made durable and its position is saved along with the
+     * blocks; a resumed sweep first brings the output back to this
+     * position. The results of each block thus reach the output exactly
+     * once, whenever the sweep was interrupted.
+     *
+     * @par Example
+     *
+     * ```cpp
+     * auto checkpoint = std::make_shared<sequence::Checkpoint>("sweep.ckpt");
+     * sequence::Sweep(mySeq, 1).withCheckpoint(checkpoint).run(n, sink);
+     * std::cout << checkpoint->summary().longestCycleLen << '\n';
+     * ```
+     *
+     * @warning
+     * Without an output, only the summary of the blocks is saved, a block
+     * done before an interruption not being given to the sink again.
+     */
+    class Checkpoint
+    {
+    public:
+        /**
+         * @brief Type representing the ordinal of a block.
+         */
+        using size_type = uint64_t;
+        /**
+         * @brief Type representing the time between two writes.
+         */
+        using duration_t = std::chrono::milliseconds;
+        /**
+         * @brief Type of the function making the output durable.
+         *
+         * It returns the position of the output from which a resumed sweep
+         * goes on, e.g. the size of the file.
+         */
+        using sync_t = std::function<uint64_t()>;
+        /**
+         * @brief Type of the function bringing the output back to a
+         * position returned by a \p sync_t.
+         */
+        using rewind_t = std::function<void(uint64_t)>;
+        /**
+         * @brief Type of the function giving the results of a block to the
+         * output.
+         */
+        using write_t = std::function<void()>;
+    public:
+        /**
+         * @brief Construct a checkpoint.
+         *
+         * The file is neither read nor written before `open()`.
+         *
+         * @param path     the path of the file
+         * @param interval the time between two writes of the file
+         */
+        explicit Checkpoint(const std::string& path,
+                            const duration_t interval = defaultInterval);
+        Checkpoint(const Checkpoint&) = delete;
+        Checkpoint& operator=(const Checkpoint&) = delete;
+        /**
+         * @brief Close the checkpoint if needed, ignoring the errors.
+         */
+        ~Checkpoint();
+
+        /**
+         * @brief Get the path of the file.
+         *
+         * @return the path
+         */
+        const std::string& path() const { return m_path; }
+        /**
+         * @brief Get the time between two writes of the file.
+         *
+         * @return the interval
+         */
+        duration_t interval() const { return m_interval; }
+        /**
+         * @brief Set the output the results of the blocks are written to.
+         *
+         * @warning
+         * The output must be set before `open()`.
+         *
+         * @param sync   the function making the output durable, run before
+         *               each write of the file
+         * @param rewind the function bringing the output back to the saved
+         *               position, run by `open()` when resuming
+         * @return       a reference to the modified object
+         */
+        Checkpoint& withOutput(const sync_t& sync, const rewind_t& rewind);
+
+        /**
+         * @brief Load the file if it exists and start saving the progress.
+         *
+         * When resuming, the output is brought back to its saved position.
+         * Otherwise the file is written at once, so that a sweep
+         * interrupted before the first interval is resumed as well.
+         *
+         * @exception std::invalid_argument if the file belongs to a sweep
+         * with other parameters, or if the checkpoint is already open
+         * @exception std::runtime_error if the file cannot be read or
+         * written
+         *
+         * @param uz        the initial terms of the first run
+         * @param value     the target value
+         * @param step      the step incrementing the initial terms
+         * @param runs      the number of runs
+         * @param blockSize the number of runs per block
+         */
+        void open(const Sequence::vec_t& uz, const int64_t value,
+                  const int64_t step, const uint64_t runs,
+                  const uint64_t blockSize);
+        /**
+         * @brief Check whether a block was done before `open()`.
+         *
+         * @param block the ordinal of the block
+         * @return      `true` if the block was done
+         */
+        bool isDone(const size_type block) const;
+        /**
+         * @brief Give the results of a block to the output and record it as
+         * done.
+         *
+         * \p write is run under the lock of the output, so that the file is
+         * never written between the results reaching the output and the
+         * block being recorded.
+         *
+         * @param block   the ordinal of the block
+         * @param summary the summary of the runs of the block
+         * @param write   the function giving the results to the output, or
+         *                `nullptr`
+         */
+        void complete(const size_type block, const Summary& summary,
+                      const write_t& write = nullptr);
+        /**
+         * @brief Stop the background thread and write the file.
+         *
+         * @exception std::runtime_error if the file cannot be written
+         */
+        void close();
+
+        /**
+         * @brief Get the number of blocks done.
+         *
+         * @return the number of blocks, including the ones pushed since the
+         *         last write
+         */
+        size_type doneBlocks();
+        /**
+         * @brief Get the summary of the blocks done.
+         *
+         * @return the summary, including the blocks pushed since the last
+         *         write
+         */
+        Summary summary();
+    public:
+        /**
+         * @brief The time between two writes used by default.
+         */
+        static constexpr duration_t defaultInterval = std::chrono::seconds(10);
+    private:
+        struct Node
+        {
+            size_type block;
+            Summary summary;
+            Node* next;
+        };
+    private:
+        bool load();
+        std::string serialize() const;
+        void save(const std::string& data) const;
+        void sync();
+        bool drain();
+        void flush();
+    private:
+        std::string m_path;
+        duration_t m_interval;
+        Sequence::vec_t m_uz;
+        int64_t m_value;
+        int64_t m_step;
+        uint64_t m_runs;
+        uint64_t m_blockSize;
+        sync_t m_sync;
+        rewind_t m_rewind;
+
+        // Held while the output is written or synced.
+        std::mutex m_outputMutex;
+
+        // The blocks done before open(), which do not change afterwards.
+        std::map<size_type, size_type> m_resumed;
+
+        std::atomic<Node*> m_pushed;
+
+        mutable std::mutex m_mutex;
+        std::map<size_type, size_type> m_done;
+        Summary m_summary;
+        uint64_t m_mark;
+        std::condition_variable m_cond;
+        std::thread m_flusher;
+        std::exception_ptr m_error;
+        bool m_open;
+        bool m_stop;
+    };
+}
+
+#endif // SYRACUSE_CHECKPOINT_HPP
@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/CollatzSequence.hpp"
+
+#include "core/Metrics.hpp"
+#include "core/Recording.hpp"
+#include "core/ResultCache.hpp"
+#include "core/ResultTable.hpp"
+#include "core/Simd.hpp"
+#include "core/StoppingTable.hpp"
+#include "core/ThreadPool.hpp"
+#include "core/Trajectory.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+namespace sequence
+{
+    namespace
+    {
+        using size_type = Sequence::vec_t::size_type;
+
+        // Go on with the run from `m`, which is not `value` and whose rank
+        // is `cycle`. If a term overflows `Int`, the run stops on the last
+        // odd term and `false` is returned, so that it can be resumed with
+        // a wider type. The steps are given to `record`, the jumps being
+        // skipped if it records anything. `stops` is only given for a
+        // `value` of 1.
+        template<typename Int, typename Record>
+        bool run(Int& m, size_type& cycle, Int& maxTerm, const int64_t value,
+                 const JumpTable* jumps, const StoppingTable* stops,
+                 const ResultCache* memo, Record& record)
+        {
+            // Halving an even term reaches `value` if and only if both
+            // share the same odd part and `value` has fewer trailing zero
+            // bits.
+            const int valueZeros = (value > 0) ? collatz::ctz(value) : 128;
+            const Int valueOdd = (value > 0) ? (value >> valueZeros) : 0;
+
+            const int64_t jumpFloor = (jumps != nullptr)
+                                      ? jumps->floor(value)
+                                      : std::numeric_limits<int64_t>::max();
+
+            // The state is kept in locals so that it stays in registers.
+            Int term = m;
+            Int peak = maxTerm;
+            size_type rank = cycle;
+            bool ret = true;
+
+            for (;;) {
+                if constexpr (std::is_same_v<Int, int64_t>
+                              && !Record::enabled) {
+                    if ((term >= jumpFloor) && (jumps != nullptr)
+                        && jumps->jump(term, rank, peak, value)) {
+                        if (term == value)
+                            break;
+
+                        continue;
+                    }
+                }
+
+                const int zeros = collatz::ctz(term);
+                const Int n = term >> zeros;
+
+                if ((n == valueOdd) && (valueZeros <= zeros)) {
+                    record.evens(term,
+                                 static_cast<size_type>(zeros - valueZeros));
+                    rank += static_cast<size_type>(zeros - valueZeros);
+                    break;
+                }
+
+                record.evens(term, static_cast<size_type>(zeros));
+                rank += static_cast<size_type>(zeros);
+
+                Sequence::Result known;
+                if ((stops != nullptr) && (n < stops->limit())
+                    && stops->find(static_cast<int64_t>(n), known)) {
+                    rank += known.cycleLen;
+                    peak = std::max(peak, Int(known.maxTerm));
+                    break;
+                }
+
+                if ((memo != nullptr) && (n < memo->limit())
+                    && memo->find(static_cast<int64_t>(n), known)) {
+                    rank += known.cycleLen;
+                    peak = std::max(peak, Int(known.maxTerm));
+                    break;
+                }
+
+                // 3n + 1 overflows exactly when n exceeds this bound, which
+                // is cheaper to check than the multiplication itself.
+                if (n > (std::numeric_limits<Int>::max() - 1) / 3) {
+                    term = n;
+                    ret = false;
+                    break;
+                }
+
+                record.odd(n);
+                ++rank;
+                term = 3 * n + 1;
+
+                if (term == value)
+                    break;
+
+                peak = std::max(peak, term);
+            }
+
+            m = term;
+            maxTerm = peak;
+            cycle = rank;
+            return ret;
+        }
+
+        void check(const Sequence::vec_t& uz)
+        {
+            if ((uz.size() != 1) || (uz.front() <= 0)) {
+                throw std::invalid_argument("CollatzSequence::doUntil(): The "
+                                            "Syracuse sequence needs a single "
+                                            "strictly positive initial term.");
+            }
+        }
+
+        template<typename Record>
+        Sequence::WideResult until(const int64_t value, const int64_t uz,
+                                   const JumpTable* jumps,
+                                   const StoppingTable* stops,
+                                   ResultCache* memo, Record& record)
+        {
+            size_type cycle = 0;
+            int128_t maxTerm = uz;
+
+            if (uz == value)
+                return { cycle, maxTerm };
+
+            // The jumps are only taken by the 64-bit loop.
+            const bool done = collatz::widen(uz, maxTerm,
+                [&](auto& m, auto& max) {
+                    return run(m, cycle, max, value, jumps, stops, memo,
+                               record);
+                });
+
+            if (!done) {
+                throw std::overflow_error("CollatzSequence::doUntilWide(): "
+                                          "The terms exceed 128 bits.");
+            }
+
+            // The results of the 128-bit loop do not fit into the cache.
+            if ((memo != nullptr)
+                && (maxTerm <= std::numeric_limits<int64_t>::max())) {
+                memo->insert(uz, { cycle, static_cast<int64_t>(maxTerm) });
+            }
+
+            return { cycle, maxTerm };
+        }
+    }
+
+    CollatzSequence::~CollatzSequence() = default;
+
+    Sequence::Result CollatzSequence::doUntil(const int64_t value,
+                                              const vec_t& uz) const
+    {
+        const WideResult ret = doUntilWide(value, uz);
+
+        if (ret.maxTerm > std::numeric_limits<int64_t>::max()) {
+            throw std::overflow_error("CollatzSequence::doUntil(): The terms "
+                                      "exceed 64 bits: use `doUntilWide()` "
+                                      "instead.");
+        }
+
+        return { ret.cycleLen, static_cast<int64_t>(ret.maxTerm) };
+    }
+
+    Sequence::WideResult CollatzSequence::doUntilWide(const int64_t value,
+                                                      const vec_t& uz) const
+    {
+        check(uz);
+
+        ResultCache* memo = nullptr;
+        if (cache() && (cache()->value() == value))
+            memo = cache().get();
+
+        // The table only holds the runs until 1.
+        const StoppingTable* stops = (value == 1) ? m_stops.get() : nullptr;
+
+        recording::None record;
+        return until(value, uz.front(), m_jumps.get(), stops, memo, record);
+    }
+
+    Sequence::WideResult
+    CollatzSequence::doUntilWide(const int64_t value, const vec_t& uz,
+                                 Trajectory& trajectory) const
+    {
+        check(uz);
+        trajectory.reset(uz.front());
+
+        // A jump or a cached result would skip the steps to record.
+        recording::Parity record{ trajectory };
+        return until(value, uz.front(), nullptr, nullptr, nullptr, record);
+    }
+
+    Ref<ResultTable> CollatzSequence::loadNUntilBatch(const uint64_t n,
+                                                      const int64_t value,
+                                                      const int64_t step) const
+    {
+        auto ret = std::make_shared<ResultTable>(uz(), step, n);
+
+        if (n == 0)
+            return ret;
+
+        if ((uz().size() != 1) || (value <= 0) || (ret->uz(0).front() <= 0)
+            || (ret->uz(n - 1).front() <= 0)) {
+            throw std::invalid_argument("CollatzSequence::loadNUntilBatch(): "
+                                        "The target value and the initial "
+                                        "terms must be strictly positive.");
+        }
+
+        ThreadPool::global().parallelFor(0, n, 0,
+            [&](const uint64_t begin, const uint64_t end) {
+                const Metrics::Chunk chunk(end - begin);
+                simd::runUntil(*ret, begin, end, value, *this);
+
+                if constexpr (Metrics::enabled) {
+                    uint64_t steps = 0;
+
+                    for (uint64_t i = begin; i < end; ++i)
+                        steps += ret->cycleLen(i);
+
+                    Metrics::add(Metrics::Steps, steps);
+                }
+            });
+
+        return ret;
+    }
+}
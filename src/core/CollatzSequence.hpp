@@ -0,0 +1,316 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_COLLATZ_SEQUENCE_HPP
+#define SYRACUSE_COLLATZ_SEQUENCE_HPP
+
+#include "core/JumpTable.hpp"
+
+namespace sequence
+{
+    class StoppingTable;
+    class Trajectory;
+
+    /**
+     * @brief Namespace providing the steps of the Syracuse sequence.
+     */
+    namespace collatz
+    {
+        /**
+         * @brief Get the next term of the Syracuse sequence.
+         *
+         * This is \f$n / 2\f$ if \p n is even, and \f$3n + 1\f$ otherwise.
+         *
+         * @param n the current term
+         * @return  the next term
+         */
+        constexpr int64_t step(const int64_t n)
+        {
+            return (n % 2 == 0) ? n / 2 : 3 * n + 1;
+        }
+
+        /**
+         * @brief Get the next term of the shortcut form of the Syracuse
+         * sequence.
+         *
+         * This is \f$n / 2\f$ if \p n is even, and \f$(3n + 1) / 2\f$
+         * otherwise, the division following an odd step being always
+         * exact. The parity is selected through a mask, without any branch.
+         *
+         * @param n the current term
+         * @return  the next term
+         */
+        constexpr int64_t shortcut(const int64_t n)
+        {
+            return (n + ((2 * n + 1) & -(n & 1))) >> 1;
+        }
+
+        /**
+         * @brief Count the trailing zero bits of a term.
+         *
+         * @warning
+         * \p n must not be zero.
+         *
+         * @param n the term
+         * @return  the number of times \p n can be halved
+         */
+        inline int ctz(const int64_t n)
+        {
+            return __builtin_ctzll(static_cast<unsigned long long>(n));
+        }
+        /**
+         * @brief Count the trailing zero bits of a 128-bit term.
+         *
+         * @warning
+         * \p n must not be zero.
+         *
+         * @param n the term
+         * @return  the number of times \p n can be halved
+         */
+        inline int ctz(const int128_t n)
+        {
+            const auto low = static_cast<int64_t>(n);
+            return (low != 0) ? ctz(low) : 64 + ctz(static_cast<int64_t>(n >> 64));
+        }
+
+        /**
+         * @brief Run a loop on 64-bit terms, and resume it on 128-bit ones
+         * once they overflow.
+         *
+         * \p loop is given the current term and the maximum term met, as
+         * `int64_t` first. If a term overflows, it must return `false`
+         * with both left where the run stopped, and it is then given them
+         * again as `int128_t`. Only the runs that overflow pay for the
+         * wider arithmetic.
+         *
+         * @param term    the first term
+         * @param maxTerm the maximum term met
+         * @param loop    the loop, callable with both types
+         * @return        `false` if the terms exceed 128 bits
+         */
+        template<typename Loop>
+        bool widen(const int64_t term, int128_t& maxTerm, Loop&& loop)
+        {
+            int64_t m = term;
+            int64_t narrowMaxTerm = term;
+
+            if (loop(m, narrowMaxTerm)) {
+                maxTerm = narrowMaxTerm;
+                return true;
+            }
+
+            int128_t wideM = m;
+            maxTerm = narrowMaxTerm;
+
+            return loop(wideM, maxTerm);
+        }
+    }
+
+    /**
+     * @class CollatzSequence core/CollatzSequence.hpp core/CollatzSequence.hpp
+     * @brief The Syracuse sequence with a dedicated evaluation engine.
+     *
+     * This class behaves like a \p Sequence built with `collatz::step()`,
+     * but `doUntil()` does not evaluate the terms one by one: each odd term
+     * is followed by \f$3n + 1\f$, whose trailing zero bits are all
+     * stripped at once. Hence, the loop never tests the parity of a term,
+     * and the statistics are exactly the same as with \p Sequence.
+     *
+     * The terms are checked against overflows: a run whose terms exceed 64
+     * bits goes on with 128-bit integers, the other ones staying at native
+     * speed.
+     *
+     * A \p JumpTable can also be given to do several steps at once far from
+     * the target value, and a \p StoppingTable to stop the runs until 1 as
+     * soon as they fall below its limit.
+     *
+     * @par Example
+     *
+     * ```cpp
+     * sequence::CollatzSequence mySeq(27);
+     * mySeq.doUntil(1).cycleLen; // returns 111
+     * ```
+     */
+    class CollatzSequence : public Sequence
+    {
+    public:
+        /**
+         * @brief The recurrence relation of the Syracuse sequence.
+         *
+         * @param un_ the last term
+         * @return    the next term
+         */
+        static int64_t relation(const vec_t& un_)
+        {
+            return collatz::step(un_[0]);
+        }
+    public:
+        /**
+         * @brief Construct an object and set the initial term.
+         *
+         * @param uz the initial term
+         */
+        CollatzSequence(const int64_t uz)
+            : Sequence({uz}, relation) {}
+        /**
+         * @brief Construct an object without setting the initial term.
+         */
+        CollatzSequence()
+            : Sequence(relation) {}
+        /**
+         * @brief Release the tables, if any.
+         */
+        ~CollatzSequence() override;
+
+        /**
+         * @brief Set the jump table used by `doUntil()`.
+         *
+         * @par Example
+         *
+         * ```cpp
+         * auto table = std::make_shared<const sequence::JumpTable>(16);
+         * sequence::CollatzSequence mySeq(27);
+         * mySeq.withJumpTable(table).doUntil(1);
+         * ```
+         *
+         * @note
+         * The same table can be shared by several objects.
+         *
+         * @param table the jump table, or `nullptr` to do the steps one by
+         *              one
+         * @return      a reference to the modified object
+         */
+        inline CollatzSequence& withJumpTable(const Ref<const JumpTable>& table);
+        /**
+         * @brief Set the stopping table used by `doUntil()` to run the
+         * sequence until 1.
+         *
+         * @par Example
+         *
+         * ```cpp
+         * auto table = std::make_shared<const sequence::StoppingTable>(20);
+         * sequence::CollatzSequence mySeq(27);
+         * mySeq.withStoppingTable(table).doUntil(1);
+         * ```
+         *
+         * @note
+         * The same table can be shared by several objects.
+         *
+         * @param table the stopping table, or `nullptr` to run the
+         *              sequence until 1 in full
+         * @return      a reference to the modified object
+         */
+        inline CollatzSequence&
+        withStoppingTable(const Ref<const StoppingTable>& table);
+
+        using Sequence::doUntil;
+        /**
+         * @brief Run the sequence until some value with the given initial
+         * term.
+         *
+         * @warning
+         * \p uz must count a single term, which must be strictly positive,
+         * or otherwise an `std::invalid_argument` will be thrown. If the
+         * terms exceed 64 bits, an `std::overflow_error` is thrown.
+         *
+         * @param value run the sequence until
+         * @param uz    the initial term
+         * @return      some statistics
+         *
+         * @see doUntilWide(const int64_t value, const vec_t& uz) const
+         */
+        Result doUntil(const int64_t value, const vec_t& uz) const override;
+        /**
+         * @brief Run the sequence until some value with the given initial
+         * term, going on with 128-bit integers if needed.
+         *
+         * @warning
+         * \p uz must count a single term, which must be strictly positive,
+         * or otherwise an `std::invalid_argument` will be thrown. If the
+         * terms exceed 128 bits, an `std::overflow_error` is thrown.
+         *
+         * @param value run the sequence until
+         * @param uz    the initial term
+         * @return      some statistics
+         */
+        WideResult doUntilWide(const int64_t value,
+                               const vec_t& uz) const override;
+        /**
+         * @brief Run the sequence until some value with the given initial
+         * term, recording its trajectory.
+         *
+         * The trajectory takes one bit per step. The jump table, the
+         * stopping table and the cache are not used, since they would skip
+         * the steps to record. The runs that do not record anything are not
+         * slowed down.
+         *
+         * @warning
+         * \p uz must count a single term, which must be strictly positive,
+         * or otherwise an `std::invalid_argument` will be thrown. If the
+         * terms exceed 128 bits, an `std::overflow_error` is thrown.
+         *
+         * @param value      run the sequence until
+         * @param uz         the initial term
+         * @param trajectory the trajectory, whose previous contents are
+         *                   replaced
+         * @return           some statistics
+         */
+        WideResult doUntilWide(const int64_t value, const vec_t& uz,
+                               Trajectory& trajectory) const;
+        /**
+         * @brief Run `doUntil()` several times, evaluating the runs in
+         * lockstep in vector registers.
+         *
+         * This method gives the same results as `loadNUntil()`, the chunks
+         * given to the threads of `ThreadPool::global()` being evaluated by
+         * `simd::runUntil()`. The jump table, the stopping table and the
+         * cache are not used.
+         *
+         * @warning
+         * \p value and all the initial terms must be strictly positive, or
+         * otherwise an `std::invalid_argument` will be thrown.
+         *
+         * @param n     run `doUntil()` \p n times
+         * @param value run the sequence until
+         * @param step  the step incrementing the initial terms
+         * @return      a pointer to a table where each \p Result is
+         *              associated with the initial terms
+         */
+        Ref<ResultTable> loadNUntilBatch(const uint64_t n, const int64_t value,
+                                         const int64_t step = 1) const;
+    private:
+        Ref<const JumpTable> m_jumps;
+        Ref<const StoppingTable> m_stops;
+    };
+
+    inline CollatzSequence&
+    CollatzSequence::withJumpTable(const Ref<const JumpTable>& table)
+    {
+        m_jumps = table;
+        return *this;
+    }
+
+    inline CollatzSequence&
+    CollatzSequence::withStoppingTable(const Ref<const StoppingTable>& table)
+    {
+        m_stops = table;
+        return *this;
+    }
+}
+
+#endif // SYRACUSE_COLLATZ_SEQUENCE_HPP
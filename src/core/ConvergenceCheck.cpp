@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/ConvergenceCheck.hpp"
+
+#include "core/CollatzSequence.hpp"
+#include "core/ThreadPool.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+
+namespace sequence
+{
+    namespace
+    {
+        using size_type = Sequence::vec_t::size_type;
+
+        // Go on with the run from the odd term `term`, not lower than `n`,
+        // until it falls below `n`. If a term overflows `Int`, the run
+        // stops on the last odd term and `false` is returned, so that it
+        // can be resumed with a wider type.
+        template<typename Int>
+        bool fall(Int& term, size_type& glide, Int& maxTerm, const int64_t n)
+        {
+            for (;;) {
+                if (term > (std::numeric_limits<Int>::max() - 1) / 3)
+                    return false;
+
+                term = 3 * term + 1;
+                ++glide;
+                maxTerm = std::max(maxTerm, term);
+
+                const int zeros = collatz::ctz(term);
+
+                if ((term >> zeros) < n) {
+                    // Only the halvings needed to fall are steps of the
+                    // glide.
+                    for (; term >= n; term >>= 1)
+                        ++glide;
+
+                    return true;
+                }
+
+                term >>= zeros;
+                glide += static_cast<size_type>(zeros);
+            }
+        }
+
+        Sequence::WideResult glide(const int64_t n)
+        {
+            if (n % 2 == 0)
+                return { 1, n };
+
+            size_type glide = 0;
+            int128_t maxTerm = n;
+
+            const bool done = collatz::widen(n, maxTerm,
+                [&](auto& term, auto& max) {
+                    return fall(term, glide, max, n);
+                });
+
+            if (!done) {
+                throw std::overflow_error("ConvergenceCheck::run(): The terms "
+                                          "exceed 128 bits.");
+            }
+
+            return { glide, maxTerm };
+        }
+    }
+
+    ConvergenceCheck::Report ConvergenceCheck::run(const int64_t first,
+                                                   const int64_t last) const
+    {
+        if (first <= 1) {
+            throw std::invalid_argument("ConvergenceCheck::run(): The initial "
+                                        "terms must be greater than 1.");
+        }
+
+        Summary summary;
+        std::mutex mutex;
+
+        // The classes of the sieve only hold from 2^k on.
+        const ResidueSieve* sieve = m_sieve.get();
+        const int64_t sifted = (sieve != nullptr)
+                               ? (int64_t(1) << sieve->bits())
+                               : std::numeric_limits<int64_t>::max();
+        const auto n = static_cast<uint64_t>(std::max(last - first,
+                                                      int64_t(0)));
+
+        ThreadPool::global().parallelFor(0, n, 0,
+            [&](const uint64_t begin, const uint64_t end) {
+                Summary local;
+
+                for (uint64_t i = begin; i < end; ++i) {
+                    const int64_t uz = first + static_cast<int64_t>(i);
+
+                    if ((uz >= sifted) && !sieve->survives(uz))
+                        continue;
+
+                    local.add(i, glide(uz));
+                }
+
+                const std::lock_guard<std::mutex> lock(mutex);
+                summary.merge(local);
+            });
+
+        const size_type skipped = n - summary.runs;
+        return { summary, skipped };
+    }
+}
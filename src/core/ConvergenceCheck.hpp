@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_CONVERGENCE_CHECK_HPP
+#define SYRACUSE_CONVERGENCE_CHECK_HPP
+
+#include "core/ResidueSieve.hpp"
+#include "core/Summary.hpp"
+
+namespace sequence
+{
+    /**
+     * @class ConvergenceCheck core/ConvergenceCheck.hpp core/ConvergenceCheck.hpp
+     * @brief A check that the initial terms of a range reach 1, assuming
+     * that all the lower ones do.
+     *
+     * Each initial term is only run until it falls below itself, the
+     * number of steps taken being its glide. The terms skipped by a
+     * \p ResidueSieve are known to fall and are not run at all, which
+     * leaves less than 10 % of the range to run from a sieve of 8 bits on.
+     *
+     * The range is split into chunks shared by the threads of
+     * `ThreadPool::global()`.
+     *
+     * @par Example
+     *
+     * ```cpp
+     * auto sieve = std::make_shared<sequence::ResidueSieve>(16);
+     * auto report = sequence::ConvergenceCheck(sieve).run(1 << 20, 1 << 21);
+     * report.skipped;                 // returns 1014752, i.e. 96.8 %
+     * report.summary.longestCycleLen; // returns the longest glide
+     * ```
+     */
+    class ConvergenceCheck
+    {
+    public:
+        /**
+         * @brief Type representing a number of runs.
+         */
+        using size_type = uint64_t;
+
+        /**
+         * @struct Report core/ConvergenceCheck.hpp
+         * @brief The outcome of a check.
+         */
+        struct Report
+        {
+            /**
+             * @var Summary summary
+             * The statistics of the runs, the lengths of the cycles being
+             * the glides and the ordinals being counted from the first
+             * initial term.
+             */
+            Summary summary;
+            /**
+             * @var size_type skipped
+             * The number of initial terms skipped by the sieve.
+             */
+            size_type skipped;
+        };
+    public:
+        /**
+         * @brief Construct a check.
+         *
+         * @param sieve the sieve of the initial terms, or `nullptr` to run
+         *              all of them
+         */
+        explicit ConvergenceCheck(const Ref<const ResidueSieve>& sieve
+                                  = nullptr)
+            : m_sieve(sieve) {}
+
+        /**
+         * @brief Get the sieve of the initial terms.
+         *
+         * @return the sieve, or `nullptr` if there is none
+         */
+        const Ref<const ResidueSieve>& sieve() const { return m_sieve; }
+
+        /**
+         * @brief Run the check over the initial terms of \f$[first,
+         * last)\f$.
+         *
+         * @warning
+         * \p first must be greater than 1, or otherwise an
+         * `std::invalid_argument` will be thrown.
+         *
+         * @warning
+         * This method waits for the threads of `ThreadPool::global()`, and
+         * thus must not be called from one of them.
+         *
+         * @exception std::overflow_error if a term exceeds 128 bits
+         *
+         * @param first the first initial term
+         * @param last  the initial term following the last one
+         * @return      the outcome of the check
+         */
+        Report run(const int64_t first, const int64_t last) const;
+    private:
+        Ref<const ResidueSieve> m_sieve;
+    };
+}
+
+#endif // SYRACUSE_CONVERGENCE_CHECK_HPP
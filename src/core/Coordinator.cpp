@@ -0,0 +1,306 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/Coordinator.hpp"
+
+#include "core/Protocol.hpp"
+#include "core/ReplaceFile.hpp"
+#include "core/ResultFile.hpp"
+
+#include <algorithm>
+#include <list>
+#include <thread>
+
+namespace sequence
+{
+    namespace
+    {
+        // Checks that a result file holds the expected runs, decoding all
+        // its blocks.
+        bool check(const std::string& path, const protocol::Chunk& chunk)
+        {
+            try {
+                const ResultFile file(path);
+
+                if ((file.size() != chunk.count) || (file.uz() != chunk.uz)
+                    || (file.value() != chunk.value)
+                    || (file.step() != chunk.step)) {
+                    return false;
+                }
+
+                for (uint64_t i = 0; i < file.size(); i += file.blockSize())
+                    file.read(i, std::min(file.blockSize(), file.size() - i));
+
+                return true;
+            } catch (const std::exception&) {
+                return false;
+            }
+        }
+    }
+
+    Coordinator::Coordinator(const std::string& directory,
+                             const Sequence::vec_t& uz, const int64_t value,
+                             const int64_t step, const size_type n,
+                             const size_type chunkSize)
+        : m_directory(directory)
+        , m_uz(uz)
+        , m_value(value)
+        , m_step(step)
+        , m_n(n)
+        , m_chunkSize(chunkSize)
+        , m_prefetch(defaultPrefetch)
+        , m_log()
+        , m_logMutex()
+        , m_mutex()
+        , m_cond()
+        , m_queue()
+        , m_remaining(0)
+        , m_error()
+    {
+        if ((n == 0) || (chunkSize == 0)) {
+            throw std::invalid_argument("Coordinator::Coordinator(): There "
+                                        "must be at least one run per "
+                                        "chunk.");
+        }
+    }
+
+    Coordinator::~Coordinator() = default;
+
+    std::string Coordinator::chunkPath(const size_type chunk) const
+    {
+        const std::string first = std::to_string(chunk * m_chunkSize);
+
+        return m_directory + "/chunk-" + std::string(20 - first.size(), '0')
+               + first + ".bin";
+    }
+
+    void Coordinator::serve(core::Socket& listener)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.clear();
+            m_error = nullptr;
+
+            for (size_type i = 0; i < chunks(); ++i) {
+                if (!check(chunkPath(i), chunk(i)))
+                    m_queue.push_back(i);
+            }
+
+            m_remaining = m_queue.size();
+        }
+
+        if (m_remaining < chunks()) {
+            log(std::to_string(chunks() - m_remaining) + " of "
+                + std::to_string(chunks()) + " chunks already stored");
+        }
+
+        // The sockets outlive their threads, so that they can be shut down
+        // while in use.
+        std::list<core::Socket> sockets;
+        std::list<std::thread> threads;
+
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                if ((m_remaining == 0) || m_error)
+                    break;
+            }
+
+            try {
+                core::Socket socket =
+                    listener.accept(std::chrono::milliseconds(200));
+
+                if (socket.isValid()) {
+                    sockets.push_back(std::move(socket));
+                    core::Socket& s = sockets.back();
+                    threads.emplace_back([this, &s] { handle(s, s.peer()); });
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                if (!m_error)
+                    m_error = std::current_exception();
+            }
+        }
+
+        // The idle workers are sent Done, and the ones not yet greeted are
+        // dropped.
+        m_cond.notify_all();
+
+        for (auto& i : sockets)
+            i.shutdown();
+
+        for (auto& i : threads)
+            i.join();
+
+        if (m_error)
+            std::rethrow_exception(m_error);
+    }
+
+    protocol::Chunk Coordinator::chunk(const size_type chunk) const
+    {
+        const size_type first = chunk * m_chunkSize;
+        protocol::Chunk ret{ chunk, m_uz, m_value, m_step,
+                             std::min(m_chunkSize, m_n - first) };
+
+        for (auto& i : ret.uz)
+            i += static_cast<int64_t>(first) * m_step;
+
+        return ret;
+    }
+
+    void Coordinator::handle(core::Socket& socket, const std::string& peer)
+    {
+        std::vector<size_type> held;
+
+        try {
+            const auto hello = socket.receive(64);
+
+            if ((hello.type != protocol::Hello) || (hello.payload.size() != 4)
+                || (core::varint::getFixed<uint32_t>(hello.payload.data())
+                    != protocol::version)) {
+                throw std::runtime_error("unsupported worker");
+            }
+
+            log(peer + ": connected");
+
+            for (;;) {
+                std::vector<protocol::Chunk> tasks;
+
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+
+                    if (held.empty()) {
+                        m_cond.wait(lock, [this] {
+                            return !m_queue.empty() || (m_remaining == 0)
+                                   || m_error;
+                        });
+                    }
+
+                    if (m_error)
+                        break;
+
+                    while ((held.size() < m_prefetch) && !m_queue.empty()) {
+                        held.push_back(m_queue.front());
+                        tasks.push_back(chunk(m_queue.front()));
+                        m_queue.pop_front();
+                    }
+                }
+
+                if (held.empty()) {
+                    socket.send({ protocol::Done, {} });
+                    log(peer + ": done");
+                    return;
+                }
+
+                for (const auto& i : tasks)
+                    socket.send(protocol::encode(i));
+
+                // A result is the ordinal of its chunk followed by its file,
+                // which cannot be larger than the one of the largest chunk.
+                uint64_t maxSize = 0;
+
+                for (const auto i : held) {
+                    const protocol::Chunk task = chunk(i);
+                    const uint64_t size =
+                        8 + ResultFile::maxSize(task.count, task.uz.size());
+
+                    maxSize = std::max(maxSize, size);
+                }
+
+                const auto result = socket.receive(maxSize);
+
+                if ((result.type != protocol::Result)
+                    || (result.payload.size() < 8)) {
+                    throw std::runtime_error("unexpected message");
+                }
+
+                const auto ordinal =
+                    core::varint::getFixed<uint64_t>(result.payload.data());
+                const auto it = std::find(held.begin(), held.end(), ordinal);
+
+                if (it == held.end())
+                    throw std::runtime_error("unexpected chunk");
+
+                bool stored;
+
+                try {
+                    stored = store(chunk(ordinal), result.payload, 8);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+
+                    if (!m_error)
+                        m_error = std::current_exception();
+
+                    break;
+                }
+
+                if (!stored)
+                    throw std::runtime_error("invalid result");
+
+                held.erase(it);
+                size_type remaining;
+
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    remaining = --m_remaining;
+                }
+
+                m_cond.notify_all();
+                log(peer + ": stored chunk " + std::to_string(ordinal) + " ("
+                    + std::to_string(chunks() - remaining) + '/'
+                    + std::to_string(chunks()) + ')');
+            }
+        } catch (const std::exception& e) {
+            log(peer + ": dropped: " + e.what());
+        }
+
+        // The chunks of the worker are handed out again, first.
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.insert(m_queue.begin(), held.begin(), held.end());
+        }
+
+        m_cond.notify_all();
+    }
+
+    bool Coordinator::store(const protocol::Chunk& chunk,
+                            const std::vector<unsigned char>& data,
+                            const std::size_t offset) const
+    {
+        // The chunk is checked before replacing the file, so that a
+        // malformed result never reaches the results of the sweep.
+        return core::replaceFile(chunkPath(chunk.ordinal),
+                                 { { data.data() + offset,
+                                     data.size() - offset } },
+                                 "Coordinator::store()",
+                                 [&](const std::string& tmp) {
+                                     return check(tmp, chunk);
+                                 });
+    }
+
+    void Coordinator::log(const std::string& message)
+    {
+        if (!m_log)
+            return;
+
+        std::lock_guard<std::mutex> lock(m_logMutex);
+        m_log(message);
+    }
+}
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_COORDINATOR_HPP
+#define SYRACUSE_COORDINATOR_HPP
+
+#include "core/Sequence.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+
+namespace core
+{
+    class Socket;
+}
+
+namespace sequence
+{
+    namespace protocol
+    {
+        struct Chunk;
+    }
+
+    /**
+     * @class Coordinator core/Coordinator.hpp core/Coordinator.hpp
+     * @brief The node splitting a sweep of the Syracuse sequence into
+     * chunks run by remote `Worker`s.
+     *
+     * The chunks are handed out on demand: each worker holds at most
+     * `prefetch()` of them and is sent another one whenever it returns a
+     * result, so that the faster nodes run more chunks. The chunks held by
+     * a worker whose connection is lost are handed out again.
+     *
+     * The result of each chunk is checked and stored as a result file
+     * named by `chunkPath()`. A chunk whose file already exists is not run
+     * again, so that an interrupted sweep resumes where it stopped.
+     *
+     * @par Example
+     *
+     * ```cpp
+     * core::Socket listener = core::Socket::listen(7420);
+     * sequence::Coordinator("sweep", {1}, 1, 1, 1000000000).serve(listener);
+     * ```
+     *
+     * @see protocol
+     */
+    class Coordinator
+    {
+    public:
+        /**
+         * @brief Type representing a number of runs or chunks.
+         */
+        using size_type = uint64_t;
+        /**
+         * @brief Type representing the consumer of the log messages.
+         */
+        using log_t = std::function<void(const std::string&)>;
+    public:
+        /**
+         * @brief Construct a coordinator.
+         *
+         * @exception std::invalid_argument if \p n or \p chunkSize is
+         * null
+         *
+         * @param directory the directory where the chunks are stored, which
+         *                  must exist
+         * @param uz        the initial terms of the first run
+         * @param value     the target value
+         * @param step      the step incrementing the initial terms
+         * @param n         the number of runs
+         * @param chunkSize the number of runs per chunk
+         */
+        Coordinator(const std::string& directory, const Sequence::vec_t& uz,
+                    const int64_t value, const int64_t step,
+                    const size_type n,
+                    const size_type chunkSize = defaultChunkSize);
+        Coordinator(const Coordinator&) = delete;
+        Coordinator& operator=(const Coordinator&) = delete;
+        /**
+         * @brief Destruct the coordinator, which must not serve anymore.
+         */
+        ~Coordinator();
+
+        /**
+         * @brief Set the number of chunks held by each worker.
+         *
+         * @param n the number of chunks, or 0 for the default one
+         * @return  a reference to the modified object
+         */
+        inline Coordinator& withPrefetch(const size_type n);
+        /**
+         * @brief Set the consumer of the log messages.
+         *
+         * The messages report the workers connecting and leaving, and the
+         * chunks stored. They are given one at a time, from any thread.
+         *
+         * @param log the consumer, or `nullptr` to log nothing
+         * @return    a reference to the modified object
+         */
+        Coordinator& withLog(const log_t& log)
+        {
+            m_log = log;
+            return *this;
+        }
+
+        /**
+         * @brief Get the number of chunks.
+         *
+         * @return the number of chunks
+         */
+        size_type chunks() const { return (m_n - 1) / m_chunkSize + 1; }
+        /**
+         * @brief Get the number of runs per chunk.
+         *
+         * @return the number of runs
+         */
+        size_type chunkSize() const { return m_chunkSize; }
+        /**
+         * @brief Get the number of chunks held by each worker.
+         *
+         * @return the number of chunks
+         */
+        size_type prefetch() const { return m_prefetch; }
+        /**
+         * @brief Get the path of the file storing a chunk.
+         *
+         * The files are named after the ordinal of their first run, so that
+         * listing them in order lists the runs in order.
+         *
+         * @param chunk the ordinal of the chunk
+         * @return      the path
+         */
+        std::string chunkPath(const size_type chunk) const;
+
+        /**
+         * @brief Serve the workers until all the chunks are stored.
+         *
+         * @note
+         * A worker sending an invalid result is disconnected and its chunks
+         * are handed out again.
+         *
+         * @exception std::runtime_error if a chunk cannot be stored
+         *
+         * @param listener the socket listening for the workers
+         */
+        void serve(core::Socket& listener);
+    public:
+        /**
+         * @brief The number of runs per chunk used by default.
+         */
+        static constexpr size_type defaultChunkSize = 1 << 22;
+        /**
+         * @brief The number of chunks held by each worker by default.
+         */
+        static constexpr size_type defaultPrefetch = 2;
+    private:
+        protocol::Chunk chunk(const size_type chunk) const;
+        void handle(core::Socket& socket, const std::string& peer);
+        bool store(const protocol::Chunk& chunk,
+                   const std::vector<unsigned char>& data,
+                   const std::size_t offset) const;
+        void log(const std::string& message);
+    private:
+        std::string m_directory;
+        Sequence::vec_t m_uz;
+        int64_t m_value;
+        int64_t m_step;
+        size_type m_n;
+        size_type m_chunkSize;
+        size_type m_prefetch;
+        log_t m_log;
+        std::mutex m_logMutex;
+
+        std::mutex m_mutex;
+        std::condition_variable m_cond;
+        std::deque<size_type> m_queue;
+        size_type m_remaining;
+        std::exception_ptr m_error;
+    };
+
+    inline Coordinator& Coordinator::withPrefetch(const size_type n)
+    {
+        m_prefetch = (n == 0) ? defaultPrefetch : n;
+        return *this;
+    }
+}
+
+#endif // SYRACUSE_COORDINATOR_HPP
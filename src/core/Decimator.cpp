@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/Decimator.hpp"
+
+#include "core/ResultTable.hpp"
+#include "core/Varint.hpp"
+
+#include <algorithm>
+
+namespace sequence
+{
+    Decimator::Decimator(const size_type n, const size_type bins)
+        : m_n(n)
+        , m_mutex()
+        , m_bins(static_cast<std::size_t>(std::max<size_type>(
+              std::min(n, bins), 1)))
+        , m_added(0)
+        , m_version(0) {}
+
+    Decimator::size_type Decimator::binOf(const size_type i) const
+    {
+        // i * bins / n overflows 64 bits for the largest sweeps.
+        return static_cast<size_type>(core::uint128_t(i) * m_bins.size()
+                                      / std::max<size_type>(m_n, 1));
+    }
+
+    Decimator::size_type Decimator::firstOf(const size_type bin) const
+    {
+        // The smallest i such that i * bins >= bin * n.
+        const core::uint128_t bins = m_bins.size();
+        return static_cast<size_type>((core::uint128_t(bin) * m_n + bins - 1)
+                                      / bins);
+    }
+
+    void Decimator::add(const ResultTable& block)
+    {
+        size_type first;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            first = m_added;
+        }
+
+        // The block is folded without the lock, a block spanning few bins.
+        std::vector<std::pair<size_type, Bin>> folded;
+
+        for (std::size_t i = 0; i < block.size(); ++i) {
+            const size_type bin = binOf(first + i);
+
+            if (bin >= m_bins.size())
+                break;
+
+            if (folded.empty() || (folded.back().first != bin))
+                folded.emplace_back(bin, Bin());
+
+            folded.back().second.add(
+                first + i, block.cycleLen(i),
+                static_cast<double>(block.wideMaxTerm(i)));
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (const auto& i : folded)
+            m_bins[static_cast<std::size_t>(i.first)].merge(i.second);
+
+        m_added += block.size();
+        m_version.fetch_add(1, std::memory_order_release);
+    }
+
+    void Decimator::clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::fill(m_bins.begin(), m_bins.end(), Bin());
+        m_added = 0;
+        m_version.fetch_add(1, std::memory_order_release);
+    }
+
+    Decimator::size_type Decimator::added() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_added;
+    }
+
+    std::vector<Decimator::Bin> Decimator::bins() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_bins;
+    }
+}
@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_DECIMATOR_HPP
+#define SYRACUSE_DECIMATOR_HPP
+
+#include "core/Sequence.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <mutex>
+
+namespace sequence
+{
+    class ResultTable;
+
+    /**
+     * @class Decimator core/Decimator.hpp core/Decimator.hpp
+     * @brief The runs of a sweep reduced to a fixed number of bins, so that
+     * they can be drawn whatever their number.
+     *
+     * The runs are spread evenly over the bins by their ordinal, and each
+     * bin keeps the extrema of their statistics. Drawing a bin as a
+     * vertical segment from its minimum to its maximum thus shows all the
+     * runs, down to the resolution of the bins.
+     *
+     * The blocks can be added while another thread takes snapshots of the
+     * bins, `version()` telling whether anything changed since the last
+     * one.
+     *
+     * @par Example
+     *
+     * ```cpp
+     * auto decimator = std::make_shared<sequence::Decimator>(n);
+     * sequence::Sweep(mySeq, 1).run(n, [&](const sequence::ResultTable& b) {
+     *     decimator->add(b);
+     * });
+     * ```
+     */
+    class Decimator
+    {
+    public:
+        /**
+         * @brief Type representing the ordinal of a run or of a bin.
+         */
+        using size_type = uint64_t;
+
+        /**
+         * @brief Type containing the extrema of the runs of a bin.
+         */
+        struct Bin
+        {
+            /**
+             * @var size_type runs
+             * @brief The number of runs added.
+             */
+            size_type runs = 0;
+            /**
+             * @var std::size_t minCycleLen
+             * @brief The shortest cycle length.
+             */
+            std::size_t minCycleLen = std::numeric_limits<std::size_t>::max();
+            /**
+             * @var std::size_t maxCycleLen
+             * @brief The longest cycle length.
+             */
+            std::size_t maxCycleLen = 0;
+            /**
+             * @var size_type longestRun
+             * @brief The ordinal of the run of the longest cycle length.
+             */
+            size_type longestRun = 0;
+            /**
+             * @var double minMaxTerm
+             * @brief The lowest maximum term.
+             */
+            double minMaxTerm = std::numeric_limits<double>::infinity();
+            /**
+             * @var double maxMaxTerm
+             * @brief The highest maximum term.
+             */
+            double maxMaxTerm = -std::numeric_limits<double>::infinity();
+            /**
+             * @var size_type highestRun
+             * @brief The ordinal of the run of the highest maximum term.
+             */
+            size_type highestRun = 0;
+
+            /**
+             * @brief Add a run.
+             *
+             * @param i        the ordinal of the run
+             * @param cycleLen the cycle length of the run
+             * @param maxTerm  the maximum term of the run
+             */
+            inline void add(const size_type i, const std::size_t cycleLen,
+                            const double maxTerm);
+            /**
+             * @brief Merge the extrema of another bin.
+             *
+             * As with `Summary`, the ties are broken by the lowest ordinal.
+             *
+             * @param other the other bin
+             */
+            inline void merge(const Bin& other);
+        };
+    public:
+        /**
+         * @brief Construct an object with empty bins.
+         *
+         * There are never more bins than runs.
+         *
+         * @param n    the number of runs of the sweep
+         * @param bins the number of bins
+         */
+        explicit Decimator(const size_type n,
+                           const size_type bins = defaultBins);
+        Decimator(const Decimator&) = delete;
+        Decimator& operator=(const Decimator&) = delete;
+
+        /**
+         * @brief Get the number of runs of the sweep.
+         *
+         * @return the number of runs
+         */
+        size_type size() const { return m_n; }
+        /**
+         * @brief Get the number of bins.
+         *
+         * @return the number of bins
+         */
+        size_type binCount() const { return m_bins.size(); }
+        /**
+         * @brief Get the bin of a run.
+         *
+         * @param i the ordinal of the run
+         * @return  the ordinal of the bin
+         */
+        size_type binOf(const size_type i) const;
+        /**
+         * @brief Get the first run of a bin.
+         *
+         * @param bin the ordinal of the bin
+         * @return    the ordinal of the run
+         */
+        size_type firstOf(const size_type bin) const;
+
+        /**
+         * @brief Add the runs of a block.
+         *
+         * The ordinal of the first run of the block is the number of runs
+         * added before, the blocks being given in order as by `Sweep`.
+         *
+         * @param block the block
+         */
+        void add(const ResultTable& block);
+        /**
+         * @brief Forget all the runs added.
+         */
+        void clear();
+
+        /**
+         * @brief Get a counter incremented whenever the bins change.
+         *
+         * @return the counter
+         */
+        uint64_t version() const
+        {
+            return m_version.load(std::memory_order_acquire);
+        }
+        /**
+         * @brief Get the number of runs added.
+         *
+         * @return the number of runs
+         */
+        size_type added() const;
+        /**
+         * @brief Get a copy of the bins.
+         *
+         * @return the bins
+         */
+        std::vector<Bin> bins() const;
+    public:
+        /**
+         * @brief The number of bins used by default, enough for any screen.
+         */
+        static constexpr size_type defaultBins = 1 << 13;
+    private:
+        size_type m_n;
+
+        mutable std::mutex m_mutex;
+        std::vector<Bin> m_bins;
+        size_type m_added;
+        std::atomic<uint64_t> m_version;
+    };
+
+    inline void Decimator::Bin::add(const size_type i,
+                                    const std::size_t cycleLen,
+                                    const double maxTerm)
+    {
+        merge({ 1, cycleLen, cycleLen, i, maxTerm, maxTerm, i });
+    }
+
+    inline void Decimator::Bin::merge(const Bin& other)
+    {
+        if (other.runs == 0)
+            return;
+
+        if ((runs == 0) || (other.maxCycleLen > maxCycleLen)
+            || ((other.maxCycleLen == maxCycleLen)
+                && (other.longestRun < longestRun))) {
+            longestRun = other.longestRun;
+        }
+
+        if ((runs == 0) || (other.maxMaxTerm > maxMaxTerm)
+            || (!(other.maxMaxTerm < maxMaxTerm)
+                && (other.highestRun < highestRun))) {
+            highestRun = other.highestRun;
+        }
+
+        runs += other.runs;
+        minCycleLen = std::min(minCycleLen, other.minCycleLen);
+        maxCycleLen = std::max(maxCycleLen, other.maxCycleLen);
+        minMaxTerm = std::min(minMaxTerm, other.minMaxTerm);
+        maxMaxTerm = std::max(maxMaxTerm, other.maxMaxTerm);
+    }
+}
+
+#endif // SYRACUSE_DECIMATOR_HPP
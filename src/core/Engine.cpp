@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/Engine.hpp"
+
+#include "config-syracuse.hpp"
+#include "core/ResultTable.hpp"
+#include "core/Simd.hpp"
+
+#ifdef SYRACUSE_OPENCL
+#include "core/OpenClEngine.hpp"
+#endif
+
+#include <stdexcept>
+
+namespace sequence
+{
+    namespace
+    {
+        class ScalarEngine : public Engine
+        {
+        public:
+            const char* name() const override { return "scalar"; }
+
+            void run(const Sequence& seq, const int64_t value,
+                     ResultTable& table) const override
+            {
+                Sequence::vec_t uz = table.uz();
+
+                for (std::size_t i = 0; i < table.size(); ++i) {
+                    table.set(i, seq.doUntilWide(value, uz));
+
+                    for (auto& j : uz)
+                        j += table.step();
+                }
+            }
+        };
+
+        class SimdEngine : public Engine
+        {
+        public:
+            const char* name() const override { return "simd"; }
+
+            void run(const Sequence& seq, const int64_t value,
+                     ResultTable& table) const override
+            {
+                const auto collatz = dynamic_cast<const CollatzSequence*>(&seq);
+
+                if (collatz == nullptr) {
+                    throw std::invalid_argument("Engine::run(): The simd "
+                                                "engine needs a "
+                                                "CollatzSequence.");
+                }
+
+                if (table.size() == 0)
+                    return;
+
+                if ((table.uz().size() != 1) || (value <= 0)
+                    || (table.uz().front() <= 0)
+                    || (table.uz(table.size() - 1).front() <= 0)) {
+                    throw std::invalid_argument("Engine::run(): The target "
+                                                "value and the initial terms "
+                                                "must be strictly positive.");
+                }
+
+                simd::runUntil(table, 0, table.size(), value, *collatz);
+            }
+        };
+    }
+
+    Ref<const Engine> Engine::make(const std::string& name)
+    {
+        if (name == "scalar") {
+            static const auto scalar = std::make_shared<const ScalarEngine>();
+            return scalar;
+        }
+
+        if (name == "simd") {
+            static const auto simd = std::make_shared<const SimdEngine>();
+            return simd;
+        }
+
+#ifdef SYRACUSE_OPENCL
+        // The device is only set up once it is asked for.
+        if (name == "opencl") {
+            static const auto opencl = std::make_shared<const OpenClEngine>();
+            return opencl;
+        }
+#endif
+
+        throw std::invalid_argument("Engine::make(): Unknown engine " + name
+                                    + ".");
+    }
+
+    std::vector<std::string> Engine::names()
+    {
+#ifdef SYRACUSE_OPENCL
+        return { "scalar", "simd", "opencl" };
+#else
+        return { "scalar", "simd" };
+#endif
+    }
+}
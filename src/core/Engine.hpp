@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_ENGINE_HPP
+#define SYRACUSE_ENGINE_HPP
+
+#include "core/Sequence.hpp"
+
+#include <string>
+
+namespace sequence
+{
+    class ResultTable;
+
+    /**
+     * @class Engine core/Engine.hpp core/Engine.hpp
+     * @brief An evaluator of the runs of a table.
+     *
+     * An engine fills a \p ResultTable with the same results as
+     * `Sequence::loadNUntil()`. A \p Sweep hands its blocks to an engine,
+     * so that the way the runs are evaluated can be chosen at run time.
+     *
+     * The engines built in are:
+     *
+     * - `"scalar"`, which calls `Sequence::doUntilWide()` for each run,
+     *   and thus uses the jump table and the cache of the sequence;
+     * - `"simd"`, which evaluates the runs of a \p CollatzSequence in
+     *   lockstep through `simd::runUntil()`;
+     * - `"opencl"`, which evaluates the runs of a \p CollatzSequence on an
+     *   OpenCL device, if the program was configured `WITH_OPENCL`.
+     *
+     * @par Example
+     *
+     * ```cpp
+     * sequence::CollatzSequence mySeq(1);
+     * sequence::Sweep(mySeq, 1)
+     *     .withEngine(sequence::Engine::make("simd"))
+     *     .run(1000000, [](const sequence::ResultTable& block) {});
+     * ```
+     */
+    class Engine
+    {
+    public:
+        /**
+         * @brief Get an engine from its name.
+         *
+         * The engines hold no state specific to a sequence, so that the
+         * same one can be shared by several sweeps.
+         *
+         * @warning
+         * If no engine has this name, an `std::invalid_argument` is thrown.
+         *
+         * @exception std::runtime_error if the engine cannot be set up, e.g.
+         * if no OpenCL device is found
+         *
+         * @param name the name of the engine
+         * @return     the engine
+         */
+        static Ref<const Engine> make(const std::string& name);
+        /**
+         * @brief Get the names of the engines built in.
+         *
+         * @return the names, the default one first
+         */
+        static std::vector<std::string> names();
+    public:
+        /**
+         * @brief Destruct the engine.
+         */
+        virtual ~Engine() = default;
+
+        /**
+         * @brief Get the name of the engine.
+         *
+         * @return the name given to `make()`
+         */
+        virtual const char* name() const = 0;
+        /**
+         * @brief Evaluate all the runs of a table.
+         *
+         * @note
+         * Several tables can be evaluated concurrently.
+         *
+         * @warning
+         * The engines dedicated to the Syracuse sequence throw an
+         * `std::invalid_argument` if \p seq is not a \p CollatzSequence, or
+         * if \p value and the initial terms are not strictly positive.
+         *
+         * @param seq   the sequence to run
+         * @param value run the sequence until
+         * @param table the table holding the initial terms and receiving
+         *              the results
+         */
+        virtual void run(const Sequence& seq, const int64_t value,
+                         ResultTable& table) const = 0;
+    };
+}
+
+#endif // SYRACUSE_ENGINE_HPP
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_FIRST_TOUCH_ALLOCATOR_HPP
+#define SYRACUSE_FIRST_TOUCH_ALLOCATOR_HPP
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace core
+{
+    /**
+     * @class FirstTouchAllocator core/FirstTouchAllocator.hpp core/FirstTouchAllocator.hpp
+     * @brief An allocator leaving the objects constructed without
+     * arguments uninitialised.
+     *
+     * A container growing through this allocator, e.g. by
+     * `std::vector::resize()`, does not write the new objects. The pages
+     * of a large block are thus only written first by the threads filling
+     * it, and Linux gives each page to the NUMA node of the thread writing
+     * it first, rather than to the one of the thread allocating the block.
+     *
+     * @tparam T the type of the objects
+     */
+    template<typename T>
+    class FirstTouchAllocator : public std::allocator<T>
+    {
+    public:
+        /**
+         * @brief The same allocator for another type.
+         *
+         * @tparam U the type of the objects
+         */
+        template<typename U>
+        struct rebind
+        {
+            /**
+             * @brief The type of the allocator.
+             */
+            using other = FirstTouchAllocator<U>;
+        };
+    public:
+        FirstTouchAllocator() = default;
+        /**
+         * @brief Construct an allocator from one for another type.
+         */
+        template<typename U>
+        FirstTouchAllocator(const FirstTouchAllocator<U>&) noexcept {}
+
+        /**
+         * @brief Default-initialise an object, which leaves a trivial one
+         * unwritten.
+         *
+         * @param p the storage of the object
+         */
+        template<typename U>
+        void construct(U* p) noexcept(
+            std::is_nothrow_default_constructible<U>::value)
+        {
+            ::new (static_cast<void*>(p)) U;
+        }
+        /**
+         * @brief Construct an object from some arguments.
+         *
+         * @param p    the storage of the object
+         * @param args the arguments of the constructor
+         */
+        template<typename U, typename... Args>
+        void construct(U* p, Args&&... args)
+        {
+            ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+        }
+    };
+}
+
+#endif // SYRACUSE_FIRST_TOUCH_ALLOCATOR_HPP
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/JumpTable.hpp"
+
+#include "core/CollatzSequence.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace sequence
+{
+    JumpTable::JumpTable(const unsigned int bits)
+        : m_bits(bits)
+        , m_mask((int64_t(1) << bits) - 1)
+        , m_entries()
+    {
+        if ((bits == 0) || (bits > maxBits)) {
+            throw std::invalid_argument("JumpTable::JumpTable(): The number "
+                                        "of steps done at once must be "
+                                        "between 1 and 20.");
+        }
+
+        m_entries.resize(std::size_t(1) << bits);
+
+        // The terms met, written as `coef * a + low`.
+        std::vector<std::pair<int64_t, int64_t>> met;
+        met.reserve(2 * bits + 1);
+
+        for (int64_t b = 0; b <= m_mask; ++b) {
+            int64_t low = b;
+            int64_t coef = int64_t(1) << bits;
+            Entry e = { 1, 0, coef, low, 0, bits };
+
+            met.clear();
+            met.emplace_back(coef, low);
+
+            for (unsigned int j = 0; j < bits; ++j) {
+                const bool odd = (low % 2 != 0);
+
+                low = collatz::shortcut(low);
+                coef /= 2;
+
+                if (odd) {
+                    // The term 3n + 1, which is twice the next one, is met
+                    // in between.
+                    coef *= 3;
+                    e.mul *= 3;
+                    ++e.steps;
+                    met.emplace_back(2 * coef, 2 * low);
+                }
+
+                met.emplace_back(coef, low);
+            }
+
+            e.add = low;
+
+            // For `a` large enough, the greatest term met is the one with
+            // the greatest factor.
+            for (const auto& [c, l] : met) {
+                if ((c > e.peakMul) || ((c == e.peakMul) && (l > e.peakAdd))) {
+                    e.peakMul = c;
+                    e.peakAdd = l;
+                }
+            }
+
+            for (const auto& [c, l] : met) {
+                if ((c < e.peakMul) && (l > e.peakAdd)) {
+                    const int64_t d = e.peakMul - c;
+                    e.minHigh = std::max(e.minHigh, (l - e.peakAdd + d - 1) / d);
+                }
+            }
+
+            m_entries[static_cast<std::size_t>(b)] = e;
+        }
+    }
+}
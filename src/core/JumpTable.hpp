@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_JUMP_TABLE_HPP
+#define SYRACUSE_JUMP_TABLE_HPP
+
+#include "config-syracuse.hpp"
+#include "core/Sequence.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace sequence
+{
+    /**
+     * @class JumpTable core/JumpTable.hpp core/JumpTable.hpp
+     * @brief A table making the Syracuse sequence advance several steps at
+     * once.
+     *
+     * Writing a term \f$n = 2^k a + b\f$ with \f$b < 2^k\f$, the \f$k\f$
+     * next steps of the shortcut form only depend on \f$b\f$, and lead to
+     * \f$3^c a + d\f$ where \f$c\f$ is the number of odd steps. This table
+     * stores these coefficients for each of the \f$2^k\f$ values of
+     * \f$b\f$, alongside an upper bound of the terms met in between.
+     *
+     * For a high part \f$a\f$ large enough, the greatest of the terms met
+     * is always the same one, so that the maximum term stays exact. A jump
+     * is only done in this case and when it cannot skip the target value.
+     */
+    class JumpTable
+    {
+    public:
+        /**
+         * @brief Type representing a number of steps.
+         */
+        using size_type = Sequence::vec_t::size_type;
+
+        /**
+         * @struct Entry core/JumpTable.hpp
+         * @brief The coefficients of a jump.
+         */
+        struct Entry
+        {
+            /**
+             * @var int64_t mul
+             * The factor \f$3^c\f$ applied to the high part.
+             */
+            int64_t mul;
+            /**
+             * @var int64_t add
+             * The term \f$d\f$ reached from the low part.
+             */
+            int64_t add;
+            /**
+             * @var int64_t peakMul
+             * The factor applied to the high part to get the greatest term
+             * met.
+             */
+            int64_t peakMul;
+            /**
+             * @var int64_t peakAdd
+             * The constant added to get the greatest term met.
+             */
+            int64_t peakAdd;
+            /**
+             * @var int64_t minHigh
+             * The lowest high part for which the greatest term met is given
+             * by \p peakMul and \p peakAdd.
+             */
+            int64_t minHigh;
+            /**
+             * @var size_type steps
+             * The number of steps of the Syracuse sequence done at once.
+             */
+            size_type steps;
+        };
+
+        /**
+         * @brief The greatest number of steps of the shortcut form a table
+         * can do at once.
+         */
+        static constexpr unsigned int maxBits = 20;
+    public:
+        /**
+         * @brief Build the table.
+         *
+         * The table counts \f$2^{bits}\f$ entries of 48 bytes.
+         *
+         * @warning
+         * \p bits must be between 1 and \p maxBits, or otherwise an
+         * `std::invalid_argument` will be thrown.
+         *
+         * @param bits the number of steps of the shortcut form done at once
+         */
+        explicit JumpTable(const unsigned int bits = SYRACUSE_JUMP_BITS);
+
+        /**
+         * @brief Get the number of steps of the shortcut form done at once.
+         *
+         * @return the number of steps
+         */
+        unsigned int bits() const { return m_bits; }
+        /**
+         * @brief Get the lowest term from which a jump cannot reach the
+         * given target value.
+         *
+         * Below this term, `jump()` fails unless \p value is greater than
+         * any term met, which is not worth checking.
+         *
+         * @param value the target value
+         * @return      the lowest term worth trying a jump from
+         */
+        inline int64_t floor(const int64_t value) const;
+
+        /**
+         * @brief Try to jump from the given term.
+         *
+         * @param n       the current term, replaced by the reached one
+         * @param cycle   the current length of the cycle, increased by the
+         *                number of steps done
+         * @param maxTerm the maximum term found until now, updated with the
+         *                terms met
+         * @param value   the target value
+         * @return        `true` if the jump has been done, `false` if it
+         *                could have skipped \p value or if the terms met are
+         *                not known exactly
+         */
+        inline bool jump(int64_t& n, size_type& cycle, int64_t& maxTerm,
+                         const int64_t value) const;
+    private:
+        unsigned int m_bits;
+        int64_t m_mask;
+        std::vector<Entry> m_entries;
+    };
+
+    inline int64_t JumpTable::floor(const int64_t value) const
+    {
+        if (value < 0)
+            return 0;
+        else if (value >= (std::numeric_limits<int64_t>::max() >> m_bits))
+            return std::numeric_limits<int64_t>::max();
+        else
+            return (value + 1) << m_bits;
+    }
+
+    inline bool JumpTable::jump(int64_t& n, size_type& cycle,
+                                int64_t& maxTerm,
+                                const int64_t value) const
+    {
+        const int64_t high = n >> m_bits;
+        const Entry& e = m_entries[static_cast<std::size_t>(n & m_mask)];
+
+        int64_t peak;
+        if ((high < e.minHigh)
+            || __builtin_mul_overflow(high, e.peakMul, &peak)
+            || __builtin_add_overflow(peak, e.peakAdd, &peak))
+            return false;
+
+        // No term met is lower than `high` or greater than `peak`.
+        if ((value >= high) && (value <= peak))
+            return false;
+
+        n = e.mul * high + e.add;
+        cycle += e.steps;
+        maxTerm = std::max(maxTerm, peak);
+        return true;
+    }
+}
+
+#endif // SYRACUSE_JUMP_TABLE_HPP
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/LinearSequence.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace sequence
+{
+    namespace
+    {
+        // The terms are computed on unsigned integers, whose overflows
+        // wrap around instead of being undefined.
+        using word_t = uint64_t;
+        using vector_t = std::vector<word_t>;
+
+        // A square matrix of order `k`, stored row by row.
+        struct Matrix
+        {
+            Sequence::vec_t::size_type k;
+            vector_t data;
+
+            word_t& operator()(const std::size_t i, const std::size_t j)
+            {
+                return data[i * k + j];
+            }
+
+            word_t operator()(const std::size_t i, const std::size_t j) const
+            {
+                return data[i * k + j];
+            }
+        };
+
+        Matrix multiply(const Matrix& a, const Matrix& b)
+        {
+            Matrix ret{ a.k, vector_t(a.k * a.k, 0) };
+
+            for (std::size_t i = 0; i < a.k; ++i) {
+                for (std::size_t l = 0; l < a.k; ++l) {
+                    const word_t x = a(i, l);
+
+                    for (std::size_t j = 0; (j < a.k) && (x != 0); ++j)
+                        ret(i, j) += x * b(l, j);
+                }
+            }
+
+            return ret;
+        }
+
+        vector_t multiply(const Matrix& a, const vector_t& v)
+        {
+            vector_t ret(a.k, 0);
+
+            for (std::size_t i = 0; i < a.k; ++i) {
+                for (std::size_t j = 0; j < a.k; ++j)
+                    ret[i] += a(i, j) * v[j];
+            }
+
+            return ret;
+        }
+    }
+
+    LinearSequence::LinearSequence(const vec_t& coefficients,
+                                   const vec_t& uz)
+        : Sequence(uz, [coefficients](const vec_t& un_) {
+              word_t ret = 0;
+
+              for (vec_t::size_type i = 0; i < coefficients.size(); ++i) {
+                  ret += static_cast<word_t>(coefficients[i])
+                         * static_cast<word_t>(un_[i]);
+              }
+
+              return static_cast<int64_t>(ret);
+          })
+        , m_coefficients(coefficients)
+    {
+        if (coefficients.empty()) {
+            throw std::invalid_argument("LinearSequence::LinearSequence(): "
+                                        "A recurrence relation needs at "
+                                        "least one coefficient.");
+        }
+    }
+
+    int64_t LinearSequence::at(const vec_t::size_type n,
+                               const vec_t& uz) const
+    {
+        return at(ranks_t{ n }, uz).front();
+    }
+
+    Sequence::vec_t LinearSequence::at(const ranks_t& ranks,
+                                       const vec_t& uz) const
+    {
+        const vec_t::size_type k = m_coefficients.size();
+
+        if (uz.size() != k) {
+            throw std::invalid_argument("LinearSequence::at(): There must be "
+                                        "as many initial terms as "
+                                        "coefficients.");
+        }
+
+        vec_t ret;
+        ret.reserve(ranks.size());
+
+        if (ranks.empty())
+            return ret;
+
+        // The companion matrix moves the state (u_n, ..., u_{n + k - 1})
+        // one rank forward.
+        Matrix companion{ k, vector_t(k * k, 0) };
+
+        for (std::size_t i = 0; i + 1 < k; ++i)
+            companion(i, i + 1) = 1;
+
+        for (std::size_t j = 0; j < k; ++j) {
+            companion(k - 1, k - 1 - j) =
+                static_cast<word_t>(m_coefficients[j]);
+        }
+
+        // `powers[j]` is the companion matrix to the power of 2^j, for all
+        // the bits of the highest rank.
+        std::size_t bits = 0;
+
+        for (auto i = *std::max_element(ranks.begin(), ranks.end()); i != 0;
+             i >>= 1) {
+            ++bits;
+        }
+
+        std::vector<Matrix> powers = { companion };
+
+        while (powers.size() < bits)
+            powers.push_back(multiply(powers.back(), powers.back()));
+
+        const vector_t state(uz.begin(), uz.end());
+
+        for (const auto n : ranks) {
+            vector_t v = state;
+            std::size_t j = 0;
+
+            for (auto i = n; i != 0; i >>= 1, ++j) {
+                if ((i & 1) != 0)
+                    v = multiply(powers[j], v);
+            }
+
+            ret.push_back(static_cast<int64_t>(v.front()));
+        }
+
+        return ret;
+    }
+}
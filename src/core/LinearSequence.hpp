@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_LINEAR_SEQUENCE_HPP
+#define SYRACUSE_LINEAR_SEQUENCE_HPP
+
+#include "core/Sequence.hpp"
+
+namespace sequence
+{
+    /**
+     * @class LinearSequence core/LinearSequence.hpp core/LinearSequence.hpp
+     * @brief A sequence defined by a linear recurrence relation with
+     * constant coefficients.
+     *
+     * The relation \f$u_{n + k} = c_0 u_{n + k - 1} + \dots + c_{k - 1} u_n\f$
+     * is given by its coefficients, the one of the most recent term coming
+     * first as for the window of \p Sequence::seq_t. This class behaves
+     * like a \p Sequence built with this relation, but `at()` does not
+     * evaluate the terms one by one: the state \f$(u_n, \dots,
+     * u_{n + k - 1})\f$ is the one of \f$u_0\f$ multiplied by the
+     * \f$n\f$th power of the companion matrix of the relation, which is
+     * computed by squaring in \f$O(k^3 \log n)\f$.
+     *
+     * The terms are computed modulo \f$2^{64}\f$, so that they are the
+     * ones of \p Sequence as long as they fit in 64 bits.
+     *
+     * @par Example
+     * The code below corresponds to the Fibonacci sequence:
+     *
+     * ```cpp
+     * sequence::LinearSequence fibonacci({1, 1}, {0, 1});
+     * fibonacci.at(90);            // returns 2880067194370816120
+     * fibonacci.at({6, 10, 6000}); // shares the powers of the matrix
+     * ```
+     */
+    class LinearSequence : public Sequence
+    {
+    public:
+        /**
+         * @brief Type representing a list of ranks.
+         */
+        using ranks_t = std::vector<vec_t::size_type>;
+    public:
+        /**
+         * @brief Construct an object from the coefficients of the relation
+         * and set the initial terms.
+         *
+         * @warning
+         * \p coefficients must not be empty, or otherwise an
+         * `std::invalid_argument` will be thrown.
+         *
+         * @param coefficients the coefficients, the one of the most recent
+         *                     term coming first
+         * @param uz           the initial terms
+         */
+        LinearSequence(const vec_t& coefficients, const vec_t& uz);
+        /**
+         * @brief Construct an object from the coefficients of the relation
+         * without setting the initial terms.
+         *
+         * @param coefficients the coefficients, the one of the most recent
+         *                     term coming first
+         *
+         * @see LinearSequence(const vec_t& coefficients, const vec_t& uz)
+         */
+        explicit LinearSequence(const vec_t& coefficients)
+            : LinearSequence(coefficients, {}) {}
+
+        /**
+         * @brief Get the coefficients of the relation.
+         *
+         * @return the coefficients, the one of the most recent term coming
+         *         first
+         */
+        const vec_t& coefficients() const { return m_coefficients; }
+
+        using Sequence::at;
+        /**
+         * @brief Get the term of the corresponding rank with the given
+         * initial terms.
+         *
+         * @warning
+         * \p uz must count as many terms as there are coefficients, or
+         * otherwise an `std::invalid_argument` will be thrown.
+         *
+         * @param n  the corresponding rank
+         * @param uz the initial terms
+         * @return   the nth term
+         */
+        int64_t at(const vec_t::size_type n, const vec_t& uz) const override;
+        /**
+         * @brief Get the terms of several ranks with the given initial
+         * terms.
+         *
+         * The powers of the matrix by powers of two are computed once for
+         * all the ranks, each of them then only costing \f$O(k^2 \log n)\f$.
+         *
+         * @warning
+         * \p uz must count as many terms as there are coefficients, or
+         * otherwise an `std::invalid_argument` will be thrown.
+         *
+         * @param ranks the ranks, in any order
+         * @param uz    the initial terms
+         * @return      the terms, in the order of \p ranks
+         */
+        vec_t at(const ranks_t& ranks, const vec_t& uz) const;
+        /**
+         * @brief Get the terms of several ranks.
+         *
+         * @mustinit{m_uz}
+         *
+         * @param ranks the ranks, in any order
+         * @return      the terms, in the order of \p ranks
+         *
+         * @see at(const ranks_t& ranks, const vec_t& uz) const
+         */
+        vec_t at(const ranks_t& ranks) const { return at(ranks, uz()); }
+    private:
+        vec_t m_coefficients;
+    };
+}
+
+#endif // SYRACUSE_LINEAR_SEQUENCE_HPP
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/MappedFile.hpp"
+
+#include "core/Varint.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace core
+{
+    MappedFile::MappedFile()
+        : m_path()
+        , m_where()
+        , m_data(nullptr)
+        , m_size(0)
+    {}
+
+    MappedFile::MappedFile(const std::string& path, const std::string& where)
+        : m_path(path)
+        , m_where(where)
+        , m_data(nullptr)
+        , m_size(0)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+        if (fd < 0)
+            throw error(std::strerror(errno));
+
+        struct stat st;
+
+        if (::fstat(fd, &st) != 0) {
+            const int err = errno;
+            ::close(fd);
+            throw error(std::strerror(err));
+        }
+
+        const auto size = static_cast<std::size_t>(st.st_size);
+
+        // An empty mapping is refused by mmap().
+        if (size == 0) {
+            ::close(fd);
+            return;
+        }
+
+        void* data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        const int err = errno;
+        ::close(fd);
+
+        if (data == MAP_FAILED)
+            throw error(std::strerror(err));
+
+        m_data = static_cast<const unsigned char*>(data);
+        m_size = size;
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : m_path(std::move(other.m_path))
+        , m_where(std::move(other.m_where))
+        , m_data(std::exchange(other.m_data, nullptr))
+        , m_size(std::exchange(other.m_size, 0))
+    {}
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other) {
+            unmap();
+
+            m_path = std::move(other.m_path);
+            m_where = std::move(other.m_where);
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+        }
+
+        return *this;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        unmap();
+    }
+
+    std::runtime_error MappedFile::error(const std::string& what) const
+    {
+        return std::runtime_error(m_where + ": " + m_path + ": " + what);
+    }
+
+    void MappedFile::checkHeader(const char* magic, const uint32_t version,
+                                 const std::size_t headerSize,
+                                 const char* notMine) const
+    {
+        if ((m_size < headerSize) || (std::memcmp(m_data, magic, 8) != 0))
+            throw error(notMine);
+
+        if (varint::getFixed<uint32_t>(m_data + 8) != version)
+            throw error("Unsupported version.");
+    }
+
+    void MappedFile::unmap()
+    {
+        if (m_data != nullptr)
+            ::munmap(const_cast<unsigned char*>(m_data), m_size);
+    }
+}
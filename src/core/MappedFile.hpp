@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_MAPPED_FILE_HPP
+#define SYRACUSE_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace core
+{
+    /**
+     * @class MappedFile core/MappedFile.hpp core/MappedFile.hpp
+     * @brief A file mapped read-only into memory.
+     *
+     * The binary files of the tables and of the results are mapped rather
+     * than read, so that their pages are only loaded once reached and are
+     * shared by the processes mapping the same file.
+     *
+     * The errors are reported as `std::runtime_error`s whose message starts
+     * with the method given to the constructor and the path of the file.
+     */
+    class MappedFile
+    {
+    public:
+        /**
+         * @brief Construct an empty mapping.
+         */
+        MappedFile();
+        /**
+         * @brief Map a file.
+         *
+         * An empty file is not mapped, `data()` then being `nullptr`.
+         *
+         * @exception std::runtime_error if the file cannot be mapped
+         *
+         * @param path  the path of the file
+         * @param where the method reading the file, starting the messages
+         *              of the errors
+         */
+        MappedFile(const std::string& path, const std::string& where);
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        /**
+         * @brief Move a mapping.
+         *
+         * @param other the mapping left empty
+         */
+        MappedFile(MappedFile&& other) noexcept;
+        /**
+         * @brief Unmap the file and take over another mapping.
+         *
+         * @param other the mapping left empty
+         * @return      a reference to the modified object
+         */
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        /**
+         * @brief Unmap the file, if any.
+         */
+        ~MappedFile();
+
+        /**
+         * @brief Get the mapped bytes.
+         *
+         * @return the bytes, or `nullptr` if nothing is mapped
+         */
+        const unsigned char* data() const { return m_data; }
+        /**
+         * @brief Get the number of mapped bytes.
+         *
+         * @return the size of the file
+         */
+        std::size_t size() const { return m_size; }
+
+        /**
+         * @brief Build an error about the file.
+         *
+         * @param what the description of the error
+         * @return     the error, naming the method and the path
+         */
+        std::runtime_error error(const std::string& what) const;
+        /**
+         * @brief Check the magic number and the version starting the file.
+         *
+         * The file starts with a magic number of 8 bytes, followed by its
+         * version as a 32-bit integer.
+         *
+         * @exception std::runtime_error if the file is shorter than its
+         * header, or has another magic number or version
+         *
+         * @param magic      the magic number
+         * @param version    the version
+         * @param headerSize the size of the header, at least 12 bytes
+         * @param notMine    the description of the error thrown for
+         *                   another kind of file
+         */
+        void checkHeader(const char* magic, const uint32_t version,
+                         const std::size_t headerSize,
+                         const char* notMine) const;
+    private:
+        void unmap();
+    private:
+        std::string m_path;
+        std::string m_where;
+        const unsigned char* m_data;
+        std::size_t m_size;
+    };
+}
+
+#endif // SYRACUSE_MAPPED_FILE_HPP
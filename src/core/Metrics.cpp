@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/Metrics.hpp"
+
+#include "core/ReplaceFile.hpp"
+#include "core/ThreadPool.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace core
+{
+    namespace
+    {
+        struct Family
+        {
+            const char* name;
+            const char* help;
+        };
+
+        // Indexed by `Metrics::Counter`. The busy time is given in seconds.
+        const Family families[Metrics::counters] = {
+            { "syracuse_runs_total", "The number of runs." },
+            { "syracuse_steps_total", "The number of steps of the runs." },
+            { "syracuse_chunks_total", "The number of chunks of runs." },
+            { "syracuse_busy_seconds_total", "The time spent in the chunks." },
+            { "syracuse_cache_hits_total",
+              "The number of lookups found in a result cache." },
+            { "syracuse_cache_misses_total",
+              "The number of lookups missed by a result cache." }
+        };
+
+        // The sums of the slots, read without stopping the threads: each
+        // value is exact, but they may not be from the same instant.
+        struct Snapshot
+        {
+            double uptime;
+            int64_t queueDepth;
+            std::vector<std::vector<uint64_t>> counters;
+            uint64_t buckets[Metrics::buckets];
+            uint64_t busyNanos;
+        };
+
+        double value(const unsigned int counter, const uint64_t n)
+        {
+            return (counter == Metrics::BusyNanos)
+                   ? static_cast<double>(n) / 1e9
+                   : static_cast<double>(n);
+        }
+
+        // The upper bound of a bucket, in seconds.
+        double bound(const unsigned int bucket)
+        {
+            return std::ldexp(1e-6, static_cast<int>(bucket));
+        }
+
+        template<typename Slots>
+        Snapshot snapshot(const Slots& slots,
+                          const std::chrono::steady_clock::time_point start)
+        {
+            Snapshot ret = {};
+            ret.uptime = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+            ret.queueDepth = ThreadPool::global().pending();
+
+            for (const auto& slot : slots) {
+                std::vector<uint64_t> counters(Metrics::counters);
+
+                for (unsigned int i = 0; i < Metrics::counters; ++i) {
+                    counters[i] =
+                        slot.counters[i].load(std::memory_order_relaxed);
+                }
+
+                for (unsigned int i = 0; i < Metrics::buckets; ++i) {
+                    ret.buckets[i] +=
+                        slot.buckets[i].load(std::memory_order_relaxed);
+                }
+
+                ret.busyNanos += counters[Metrics::BusyNanos];
+                ret.counters.push_back(std::move(counters));
+            }
+
+            return ret;
+        }
+    }
+
+    thread_local Metrics::Slot* Metrics::t_slot = nullptr;
+
+    Metrics::Metrics()
+        : m_start(std::chrono::steady_clock::now())
+        , m_mutex()
+        , m_slots() {}
+
+    Metrics& Metrics::global()
+    {
+        static Metrics metrics;
+        return metrics;
+    }
+
+    Metrics::Slot& Metrics::attach()
+    {
+        // The slots live as long as the metrics, so that the counts of the
+        // threads that have exited are kept.
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_slots.emplace_back();
+        t_slot = &m_slots.back();
+        return *t_slot;
+    }
+
+    std::string Metrics::prometheus() const
+    {
+        Snapshot s;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            s = snapshot(m_slots, m_start);
+        }
+
+        std::ostringstream out;
+        out.precision(9);
+
+        out << "# HELP syracuse_uptime_seconds The time elapsed since the "
+               "metrics were created.\n"
+               "# TYPE syracuse_uptime_seconds gauge\n"
+               "syracuse_uptime_seconds " << s.uptime << "\n"
+               "# HELP syracuse_queue_depth The number of tasks queued and "
+               "not started yet.\n"
+               "# TYPE syracuse_queue_depth gauge\n"
+               "syracuse_queue_depth " << s.queueDepth << '\n';
+
+        for (unsigned int i = 0; i < counters; ++i) {
+            out << "# HELP " << families[i].name << ' ' << families[i].help
+                << "\n# TYPE " << families[i].name << " counter\n";
+
+            for (std::size_t j = 0; j < s.counters.size(); ++j) {
+                out << families[i].name << "{thread=\"" << j << "\"} "
+                    << value(i, s.counters[j][i]) << '\n';
+            }
+        }
+
+        // The buckets of Prometheus are cumulative.
+        out << "# HELP syracuse_chunk_duration_seconds The durations of the "
+               "chunks of runs.\n"
+               "# TYPE syracuse_chunk_duration_seconds histogram\n";
+
+        uint64_t count = 0;
+
+        for (unsigned int i = 0; i < buckets; ++i) {
+            count += s.buckets[i];
+            out << "syracuse_chunk_duration_seconds_bucket{le=\"";
+
+            if (i + 1 < buckets)
+                out << bound(i);
+            else
+                out << "+Inf";
+
+            out << "\"} " << count << '\n';
+        }
+
+        out << "syracuse_chunk_duration_seconds_sum "
+            << value(BusyNanos, s.busyNanos)
+            << "\nsyracuse_chunk_duration_seconds_count " << count << '\n';
+
+        return out.str();
+    }
+
+    std::string Metrics::json() const
+    {
+        Snapshot s;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            s = snapshot(m_slots, m_start);
+        }
+
+        // The keys are the names of the Prometheus families, without the
+        // prefix.
+        std::ostringstream out;
+        out.precision(9);
+
+        out << "{\"uptime_seconds\":" << s.uptime
+            << ",\"queue_depth\":" << s.queueDepth << ",\"threads\":[";
+
+        for (std::size_t j = 0; j < s.counters.size(); ++j) {
+            out << ((j == 0) ? "{" : ",{");
+
+            for (unsigned int i = 0; i < counters; ++i) {
+                out << ((i == 0) ? "\"" : ",\"")
+                    << (families[i].name + std::strlen("syracuse_")) << "\":"
+                    << value(i, s.counters[j][i]);
+            }
+
+            out << '}';
+        }
+
+        out << "],\"chunk_duration_seconds\":{\"bounds\":[";
+
+        for (unsigned int i = 0; i + 1 < buckets; ++i)
+            out << ((i == 0) ? "" : ",") << bound(i);
+
+        out << "],\"counts\":[";
+
+        for (unsigned int i = 0; i < buckets; ++i)
+            out << ((i == 0) ? "" : ",") << s.buckets[i];
+
+        out << "],\"sum\":" << value(BusyNanos, s.busyNanos) << "}}\n";
+
+        return out.str();
+    }
+
+    void Metrics::save(const std::string& path) const
+    {
+        const bool json = (path.size() >= 5)
+                          && (path.compare(path.size() - 5, 5, ".json") == 0);
+        const std::string data = json ? this->json() : prometheus();
+
+        // The file is replaced at once, so that a scraper never reads it
+        // half-written.
+        core::replaceFile(path, { { data.data(), data.size() } },
+                          "Metrics::save()");
+    }
+}
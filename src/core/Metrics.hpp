@@ -0,0 +1,269 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_METRICS_HPP
+#define SYRACUSE_METRICS_HPP
+
+#include "config-syracuse.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+
+namespace core
+{
+    /**
+     * @class Metrics core/Metrics.hpp core/Metrics.hpp
+     * @brief The counters of the work done by the threads.
+     *
+     * Each thread counts into a slot of its own with relaxed atomics, so
+     * that counting takes no lock and does not share cache lines. The slots
+     * are only summed up when the metrics are read, as Prometheus text or
+     * as JSON.
+     *
+     * The chunks of runs, i.e. the chunks of `Sequence::loadNUntil()` and
+     * `CollatzSequence::loadNUntilBatch()` and the blocks of \p Sweep, are
+     * timed by a \p Chunk into a histogram whose buckets are powers of two
+     * of microseconds.
+     *
+     * The metrics are only collected if the program was configured
+     * `WITH_METRICS`: otherwise, `enabled` is `false` and the counting
+     * functions are empty, so that the runs pay nothing.
+     *
+     * @par Example
+     *
+     * ```cpp
+     * mySeq.loadNUntil(1000000, 1);
+     * core::Metrics::global().save("syracuse.prom");
+     * ```
+     */
+    class Metrics
+    {
+    public:
+        /**
+         * @brief The counters of a thread.
+         */
+        enum Counter : unsigned int
+        {
+            /**
+             * @brief The number of runs.
+             */
+            Runs,
+            /**
+             * @brief The number of steps of the runs.
+             */
+            Steps,
+            /**
+             * @brief The number of chunks.
+             */
+            Chunks,
+            /**
+             * @brief The time spent in the chunks, in nanoseconds.
+             */
+            BusyNanos,
+            /**
+             * @brief The number of lookups found in a \p ResultCache.
+             */
+            CacheHits,
+            /**
+             * @brief The number of lookups missed by a \p ResultCache.
+             */
+            CacheMisses
+        };
+
+        class Chunk;
+
+#ifdef SYRACUSE_METRICS
+        /**
+         * @brief Whether the metrics are collected.
+         */
+        static constexpr bool enabled = true;
+#else
+        static constexpr bool enabled = false;
+#endif
+        /**
+         * @brief The number of counters.
+         */
+        static constexpr unsigned int counters = CacheMisses + 1;
+        /**
+         * @brief The number of buckets of the histogram of the durations of
+         * the chunks, the bucket \f$i\f$ counting the chunks lasting less
+         * than \f$2^i\f$ µs and the last one the longer ones.
+         */
+        static constexpr unsigned int buckets = 25;
+    public:
+        Metrics(const Metrics&) = delete;
+        Metrics& operator=(const Metrics&) = delete;
+
+        /**
+         * @brief Get the metrics shared by the whole program.
+         *
+         * @return a reference to the global metrics
+         */
+        static Metrics& global();
+
+        /**
+         * @brief Add to a counter of the calling thread in the global
+         * metrics.
+         *
+         * @param counter the counter
+         * @param n       the amount added
+         */
+        static inline void add(const Counter counter, const uint64_t n);
+        /**
+         * @brief Count a chunk of the calling thread in the global metrics.
+         *
+         * @param nanos the duration of the chunk, in nanoseconds
+         */
+        static inline void chunk(const uint64_t nanos);
+
+        /**
+         * @brief Get the metrics as Prometheus text.
+         *
+         * The counters are given per thread, the histogram and the depth of
+         * the queues of `ThreadPool::global()` being global.
+         *
+         * @return the text exposition of the metrics
+         */
+        std::string prometheus() const;
+        /**
+         * @brief Get the metrics as JSON.
+         *
+         * @return a JSON object holding the same metrics as `prometheus()`
+         */
+        std::string json() const;
+        /**
+         * @brief Write the metrics to a file, as JSON if its name ends with
+         * `.json` and as Prometheus text otherwise.
+         *
+         * The file is replaced at once, so that a scraper never reads it
+         * half-written.
+         *
+         * @exception std::runtime_error if the file cannot be written
+         *
+         * @param path the path of the file
+         */
+        void save(const std::string& path) const;
+    private:
+        struct alignas(64) Slot
+        {
+            std::atomic<uint64_t> counters[Metrics::counters] = {};
+            std::atomic<uint64_t> buckets[Metrics::buckets] = {};
+        };
+    private:
+        Metrics();
+
+        static inline Slot& local();
+        Slot& attach();
+    private:
+        std::chrono::steady_clock::time_point m_start;
+        mutable std::mutex m_mutex;
+        std::deque<Slot> m_slots;
+        static thread_local Slot* t_slot;
+    };
+
+    /**
+     * @class Metrics::Chunk core/Metrics.hpp core/Metrics.hpp
+     * @brief A timer counting a chunk of runs once destructed.
+     *
+     * @par Example
+     *
+     * ```cpp
+     * {
+     *     const core::Metrics::Chunk chunk(end - begin);
+     *     // run the chunk
+     * }
+     * ```
+     */
+    class Metrics::Chunk
+    {
+    public:
+        /**
+         * @brief Start timing a chunk.
+         *
+         * @param runs the number of runs of the chunk
+         */
+        explicit Chunk(const uint64_t runs)
+            : m_start()
+        {
+            if constexpr (enabled) {
+                m_start = std::chrono::steady_clock::now();
+                add(Runs, runs);
+            } else {
+                static_cast<void>(runs);
+            }
+        }
+        Chunk(const Chunk&) = delete;
+        Chunk& operator=(const Chunk&) = delete;
+        /**
+         * @brief Count the chunk.
+         */
+        ~Chunk()
+        {
+            if constexpr (enabled) {
+                const auto nanos =
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - m_start);
+
+                chunk(static_cast<uint64_t>(nanos.count()));
+            }
+        }
+    private:
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    inline void Metrics::add(const Counter counter, const uint64_t n)
+    {
+        if constexpr (enabled) {
+            local().counters[counter].fetch_add(n, std::memory_order_relaxed);
+        } else {
+            static_cast<void>(counter);
+            static_cast<void>(n);
+        }
+    }
+
+    inline void Metrics::chunk(const uint64_t nanos)
+    {
+        if constexpr (enabled) {
+            Slot& slot = local();
+            unsigned int bucket = 0;
+
+            for (uint64_t i = nanos / 1000; (i != 0) && (bucket + 1 < buckets);
+                 i >>= 1) {
+                ++bucket;
+            }
+
+            slot.counters[Chunks].fetch_add(1, std::memory_order_relaxed);
+            slot.counters[BusyNanos].fetch_add(nanos,
+                                               std::memory_order_relaxed);
+            slot.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        } else {
+            static_cast<void>(nanos);
+        }
+    }
+
+    inline Metrics::Slot& Metrics::local()
+    {
+        return (t_slot != nullptr) ? *t_slot : global().attach();
+    }
+}
+
+#endif // SYRACUSE_METRICS_HPP
@@ -0,0 +1,314 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/OpenClEngine.hpp"
+
+#include "core/CollatzSequence.hpp"
+#include "core/ResultTable.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#define CL_TARGET_OPENCL_VERSION 120
+#include <CL/cl.h>
+
+namespace sequence
+{
+    namespace
+    {
+        // The kernel runs the plain form, one run per work item. A run
+        // whose terms would exceed 64 bits stops with a negative maximum
+        // term.
+        const char* const source = R"(
+            __kernel void runUntil(const long first, const long step,
+                                   const long value,
+                                   __global ulong* cycleLens,
+                                   __global long* maxTerms)
+            {
+                const size_t i = get_global_id(0);
+                long term = first + (long) i * step;
+                long peak = term;
+                ulong cycle = 0;
+
+                while (term != value) {
+                    if (term & 1) {
+                        if (term > (LONG_MAX - 1) / 3) {
+                            peak = -1;
+                            break;
+                        }
+
+                        term = 3 * term + 1;
+                        peak = max(peak, term);
+                    } else {
+                        term >>= 1;
+                    }
+
+                    ++cycle;
+                }
+
+                cycleLens[i] = cycle;
+                maxTerms[i] = peak;
+            }
+        )";
+
+        void check(const cl_int err, const char* what)
+        {
+            if (err != CL_SUCCESS) {
+                throw std::runtime_error(std::string("OpenClEngine: ") + what
+                                         + ": error " + std::to_string(err)
+                                         + '.');
+            }
+        }
+    }
+
+    // The buffers are taken in turn by the slices: while one is read back,
+    // the other one is being computed.
+    struct OpenClEngine::Device
+    {
+        cl_context context = nullptr;
+        cl_command_queue queues[2] = {};
+        cl_program program = nullptr;
+        cl_kernel kernel = nullptr;
+        cl_mem cycleLens[2] = {};
+        cl_mem maxTerms[2] = {};
+        std::vector<cl_ulong> hostCycleLens[2];
+        std::vector<cl_long> hostMaxTerms[2];
+
+        ~Device()
+        {
+            for (int i = 0; i < 2; ++i) {
+                if (maxTerms[i] != nullptr)
+                    clReleaseMemObject(maxTerms[i]);
+
+                if (cycleLens[i] != nullptr)
+                    clReleaseMemObject(cycleLens[i]);
+
+                if (queues[i] != nullptr)
+                    clReleaseCommandQueue(queues[i]);
+            }
+
+            if (kernel != nullptr)
+                clReleaseKernel(kernel);
+
+            if (program != nullptr)
+                clReleaseProgram(program);
+
+            if (context != nullptr)
+                clReleaseContext(context);
+        }
+    };
+
+    OpenClEngine::OpenClEngine(const size_type sliceSize)
+        : m_sliceSize(std::max(sliceSize, size_type(1)))
+        , m_deviceName()
+        , m_device(std::make_unique<Device>())
+        , m_mutex()
+    {
+        cl_uint count = 0;
+
+        if ((clGetPlatformIDs(0, nullptr, &count) != CL_SUCCESS)
+            || (count == 0)) {
+            throw std::runtime_error("OpenClEngine::OpenClEngine(): No "
+                                     "OpenCL platform was found.");
+        }
+
+        std::vector<cl_platform_id> platforms(count);
+        check(clGetPlatformIDs(count, platforms.data(), nullptr),
+              "clGetPlatformIDs()");
+
+        // A GPU is preferred to any other device.
+        cl_device_id device = nullptr;
+
+        const cl_device_type types[] = { CL_DEVICE_TYPE_GPU,
+                                         CL_DEVICE_TYPE_ALL };
+
+        for (const auto type : types) {
+            for (const auto platform : platforms) {
+                if ((device == nullptr)
+                    && (clGetDeviceIDs(platform, type, 1, &device, nullptr)
+                        != CL_SUCCESS)) {
+                    device = nullptr;
+                }
+            }
+        }
+
+        if (device == nullptr) {
+            throw std::runtime_error("OpenClEngine::OpenClEngine(): No "
+                                     "OpenCL device was found.");
+        }
+
+        std::size_t size = 0;
+        check(clGetDeviceInfo(device, CL_DEVICE_NAME, 0, nullptr, &size),
+              "clGetDeviceInfo()");
+        m_deviceName.resize(size);
+        check(clGetDeviceInfo(device, CL_DEVICE_NAME, size, &m_deviceName[0],
+                              nullptr),
+              "clGetDeviceInfo()");
+        m_deviceName.erase(m_deviceName.find_last_not_of('\0') + 1);
+
+        Device& d = *m_device;
+        cl_int err;
+
+        d.context = clCreateContext(nullptr, 1, &device, nullptr, nullptr,
+                                    &err);
+        check(err, "clCreateContext()");
+
+        for (auto& queue : d.queues) {
+            queue = clCreateCommandQueue(d.context, device, 0, &err);
+            check(err, "clCreateCommandQueue()");
+        }
+
+        const char* text = source;
+        d.program = clCreateProgramWithSource(d.context, 1, &text, nullptr,
+                                              &err);
+        check(err, "clCreateProgramWithSource()");
+
+        if (clBuildProgram(d.program, 1, &device, "", nullptr, nullptr)
+            != CL_SUCCESS) {
+            std::string log;
+
+            if (clGetProgramBuildInfo(d.program, device, CL_PROGRAM_BUILD_LOG,
+                                      0, nullptr, &size) == CL_SUCCESS) {
+                log.resize(size);
+                clGetProgramBuildInfo(d.program, device, CL_PROGRAM_BUILD_LOG,
+                                      size, &log[0], nullptr);
+            }
+
+            throw std::runtime_error("OpenClEngine::OpenClEngine(): The "
+                                     "kernel cannot be built: " + log);
+        }
+
+        d.kernel = clCreateKernel(d.program, "runUntil", &err);
+        check(err, "clCreateKernel()");
+
+        for (int i = 0; i < 2; ++i) {
+            d.cycleLens[i] = clCreateBuffer(d.context, CL_MEM_WRITE_ONLY,
+                                            m_sliceSize * sizeof(cl_ulong),
+                                            nullptr, &err);
+            check(err, "clCreateBuffer()");
+            d.maxTerms[i] = clCreateBuffer(d.context, CL_MEM_WRITE_ONLY,
+                                           m_sliceSize * sizeof(cl_long),
+                                           nullptr, &err);
+            check(err, "clCreateBuffer()");
+
+            d.hostCycleLens[i].resize(m_sliceSize);
+            d.hostMaxTerms[i].resize(m_sliceSize);
+        }
+    }
+
+    OpenClEngine::~OpenClEngine() = default;
+
+    void OpenClEngine::run(const Sequence& seq, const int64_t value,
+                           ResultTable& table) const
+    {
+        const auto collatz = dynamic_cast<const CollatzSequence*>(&seq);
+
+        if (collatz == nullptr) {
+            throw std::invalid_argument("OpenClEngine::run(): The opencl "
+                                        "engine needs a CollatzSequence.");
+        }
+
+        if (table.size() == 0)
+            return;
+
+        if ((table.uz().size() != 1) || (value <= 0)
+            || (table.uz().front() <= 0)
+            || (table.uz(table.size() - 1).front() <= 0)) {
+            throw std::invalid_argument("OpenClEngine::run(): The target "
+                                        "value and the initial terms must be "
+                                        "strictly positive.");
+        }
+
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        Device& d = *m_device;
+        const size_type slices = (table.size() - 1) / m_sliceSize + 1;
+
+        const auto bounds = [&](const size_type slice) {
+            const size_type begin = slice * m_sliceSize;
+            return std::make_pair(begin,
+                                  std::min(m_sliceSize, table.size() - begin));
+        };
+
+        // The arguments are copied when the kernel is enqueued, so that a
+        // single kernel serves both buffers.
+        const auto enqueue = [&](const size_type slice) {
+            const int i = static_cast<int>(slice % 2);
+            const auto [begin, count] = bounds(slice);
+            const cl_long first = table.uz(begin).front();
+            const cl_long step = table.step();
+            const cl_long target = value;
+
+            check(clSetKernelArg(d.kernel, 0, sizeof(first), &first),
+                  "clSetKernelArg()");
+            check(clSetKernelArg(d.kernel, 1, sizeof(step), &step),
+                  "clSetKernelArg()");
+            check(clSetKernelArg(d.kernel, 2, sizeof(target), &target),
+                  "clSetKernelArg()");
+            check(clSetKernelArg(d.kernel, 3, sizeof(cl_mem), &d.cycleLens[i]),
+                  "clSetKernelArg()");
+            check(clSetKernelArg(d.kernel, 4, sizeof(cl_mem), &d.maxTerms[i]),
+                  "clSetKernelArg()");
+            check(clEnqueueNDRangeKernel(d.queues[i], d.kernel, 1, nullptr,
+                                         &count, nullptr, 0, nullptr, nullptr),
+                  "clEnqueueNDRangeKernel()");
+            check(clEnqueueReadBuffer(d.queues[i], d.cycleLens[i], CL_FALSE, 0,
+                                      count * sizeof(cl_ulong),
+                                      d.hostCycleLens[i].data(), 0, nullptr,
+                                      nullptr),
+                  "clEnqueueReadBuffer()");
+            check(clEnqueueReadBuffer(d.queues[i], d.maxTerms[i], CL_FALSE, 0,
+                                      count * sizeof(cl_long),
+                                      d.hostMaxTerms[i].data(), 0, nullptr,
+                                      nullptr),
+                  "clEnqueueReadBuffer()");
+            check(clFlush(d.queues[i]), "clFlush()");
+        };
+
+        try {
+            enqueue(0);
+
+            for (size_type slice = 0; slice < slices; ++slice) {
+                const int i = static_cast<int>(slice % 2);
+                const auto [begin, count] = bounds(slice);
+
+                if (slice + 1 < slices)
+                    enqueue(slice + 1);
+
+                check(clFinish(d.queues[i]), "clFinish()");
+
+                for (size_type j = 0; j < count; ++j) {
+                    if (d.hostMaxTerms[i][j] < 0) {
+                        table.set(begin + j,
+                                  collatz->doUntilWide(value,
+                                                       table.uz(begin + j)));
+                    } else {
+                        table.set(begin + j, Sequence::Result{
+                            static_cast<std::size_t>(d.hostCycleLens[i][j]),
+                            d.hostMaxTerms[i][j] });
+                    }
+                }
+            }
+        } catch (...) {
+            // The slice still in flight must not write to the buffers of the
+            // next table.
+            clFinish(d.queues[0]);
+            clFinish(d.queues[1]);
+            throw;
+        }
+    }
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_OPENCL_ENGINE_HPP
+#define SYRACUSE_OPENCL_ENGINE_HPP
+
+#include "core/Engine.hpp"
+
+#include <mutex>
+
+namespace sequence
+{
+    /**
+     * @class OpenClEngine core/OpenClEngine.hpp core/OpenClEngine.hpp
+     * @brief An engine evaluating the runs of the Syracuse sequence on an
+     * OpenCL device.
+     *
+     * This class is only built if the program was configured
+     * `WITH_OPENCL`, and is then available as the `"opencl"` engine.
+     *
+     * Each work item runs one initial term of a slice of the table, its
+     * initial term being computed from its index, so that nothing is sent
+     * to the device. A slice is read back into two flat arrays while the
+     * next one is being computed, two sets of buffers being used in turn.
+     * The runs whose terms exceed 64 bits are only flagged by the device and
+     * run again by `CollatzSequence::doUntilWide()`.
+     *
+     * The device is shared by the tables evaluated concurrently, which
+     * wait for each other.
+     */
+    class OpenClEngine : public Engine
+    {
+    public:
+        /**
+         * @brief Type representing a number of runs.
+         */
+        using size_type = std::size_t;
+
+        /**
+         * @brief The number of runs per slice used by default.
+         */
+        static constexpr size_type defaultSliceSize = 1 << 14;
+    public:
+        /**
+         * @brief Set up the first GPU found, or the first device if there is
+         * none.
+         *
+         * @exception std::runtime_error if no device is found or the kernel
+         * cannot be built
+         *
+         * @param sliceSize the number of runs computed at once
+         */
+        explicit OpenClEngine(const size_type sliceSize = defaultSliceSize);
+        OpenClEngine(const OpenClEngine&) = delete;
+        OpenClEngine& operator=(const OpenClEngine&) = delete;
+        /**
+         * @brief Release the device.
+         */
+        ~OpenClEngine() override;
+
+        const char* name() const override { return "opencl"; }
+        /**
+         * @brief Get the name of the device.
+         *
+         * @return the name given by the driver
+         */
+        const std::string& device() const { return m_deviceName; }
+        /**
+         * @brief Get the number of runs computed at once.
+         *
+         * @return the number of runs
+         */
+        size_type sliceSize() const { return m_sliceSize; }
+
+        void run(const Sequence& seq, const int64_t value,
+                 ResultTable& table) const override;
+    private:
+        struct Device;
+    private:
+        size_type m_sliceSize;
+        std::string m_deviceName;
+        std::unique_ptr<Device> m_device;
+        mutable std::mutex m_mutex;
+    };
+}
+
+#endif // SYRACUSE_OPENCL_ENGINE_HPP
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_POOL_HPP
+#define SYRACUSE_POOL_HPP
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace core
+{
+    /**
+     * @class Pool core/Pool.hpp core/Pool.hpp
+     * @brief A free list of objects whose storage is reused.
+     *
+     * An object given back to a pool keeps its storage, e.g. the capacity
+     * of a vector, so that taking it again allocates nothing. Since the
+     * objects are moved in and out, an object taken from a pool can be
+     * given back to another one, e.g. the one of another thread.
+     *
+     * Each thread has a pool of its own through `local()`, which needs no
+     * lock. Otherwise, a pool is not thread-safe.
+     *
+     * @par Example
+     *
+     * ```cpp
+     * auto* pool = core::Pool<std::vector<int64_t>>::local();
+     * auto window = pool->take();  // allocates nothing if pool->spare() > 0
+     * // ...
+     * pool->give(std::move(window));
+     * ```
+     *
+     * @tparam T the type of the objects, which must be default-constructible
+     *           and movable
+     */
+    template<typename T>
+    class Pool
+    {
+    public:
+        /**
+         * @brief Type representing a number of objects.
+         */
+        using size_type = std::size_t;
+    public:
+        /**
+         * @brief Construct an empty pool.
+         *
+         * @param maxSpare the maximum number of objects kept
+         */
+        explicit Pool(const size_type maxSpare = defaultMaxSpare)
+            : m_spare(), m_maxSpare(maxSpare) {}
+
+        /**
+         * @brief Get the pool of the current thread.
+         *
+         * @return a pointer to the pool, or `nullptr` if it was already
+         *         destroyed because the thread is exiting
+         */
+        static inline Pool* local() noexcept;
+
+        /**
+         * @brief Get the number of objects kept.
+         *
+         * @return the number of objects
+         */
+        size_type spare() const { return m_spare.size(); }
+
+        /**
+         * @brief Take an object, default-constructed if none is kept.
+         *
+         * The object is left as it was given back: its contents must be
+         * reset by the caller.
+         *
+         * @return the object
+         */
+        inline T take();
+        /**
+         * @brief Give an object back.
+         *
+         * The object is destroyed if the pool is full.
+         *
+         * @param object the object
+         */
+        inline void give(T&& object);
+        /**
+         * @brief Destroy all the objects kept at once.
+         */
+        void release() { std::vector<T>().swap(m_spare); }
+    public:
+        /**
+         * @brief The maximum number of objects kept by default.
+         */
+        static constexpr size_type defaultMaxSpare = 64;
+    private:
+        std::vector<T> m_spare;
+        size_type m_maxSpare;
+    };
+
+    template<typename T>
+    inline Pool<T>* Pool<T>::local() noexcept
+    {
+        // The flag has no destructor, and thus stays readable while the
+        // thread-local objects are destroyed.
+        static thread_local bool destroyed = false;
+        static thread_local struct Local
+        {
+            Pool pool;
+            ~Local() { destroyed = true; }
+        } local;
+
+        return destroyed ? nullptr : &local.pool;
+    }
+
+    template<typename T>
+    inline T Pool<T>::take()
+    {
+        if (m_spare.empty())
+            return T();
+
+        T ret = std::move(m_spare.back());
+        m_spare.pop_back();
+
+        return ret;
+    }
+
+    template<typename T>
+    inline void Pool<T>::give(T&& object)
+    {
+        if (m_spare.size() < m_maxSpare)
+            m_spare.push_back(std::move(object));
+    }
+}
+
+#endif // SYRACUSE_POOL_HPP
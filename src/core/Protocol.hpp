@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_PROTOCOL_HPP
+#define SYRACUSE_PROTOCOL_HPP
+
+#include "core/Sequence.hpp"
+#include "core/Socket.hpp"
+#include "core/Varint.hpp"
+
+#include <stdexcept>
+
+/**
+ * @brief The messages exchanged by a `Coordinator` and its `Worker`s.
+ *
+ * A worker connects and sends `Hello`. The coordinator answers with up to
+ * `Coordinator::prefetch()` `Task`s, and with another one for each
+ * `Result` received, until there is none left: it then sends `Done` and
+ * closes the connection.
+ *
+ * All the integers are little-endian.
+ */
+namespace sequence::protocol
+{
+    /**
+     * @brief The version of the protocol, sent by `Hello`.
+     */
+    constexpr uint32_t version = 1;
+
+    /**
+     * @brief Type representing the type of a message.
+     */
+    enum Type : uint32_t
+    {
+        /**
+         * @brief Sent by a worker when it connects. The payload holds the
+         * version of the protocol, as an `uint32_t`.
+         */
+        Hello = 1,
+        /**
+         * @brief A chunk to run. The payload is a `Task`.
+         */
+        Task = 2,
+        /**
+         * @brief The runs of a chunk. The payload holds the ordinal of the
+         * chunk, as an `uint64_t`, followed by a result file written by
+         * `BinaryWriter`.
+         */
+        Result = 3,
+        /**
+         * @brief Sent by the coordinator when all the chunks are done.
+         */
+        Done = 4
+    };
+
+    /**
+     * @brief Type representing a chunk to run.
+     */
+    struct Chunk
+    {
+        /**
+         * @var uint64_t ordinal
+         * @brief The ordinal of the chunk.
+         */
+        uint64_t ordinal;
+        /**
+         * @var Sequence::vec_t uz
+         * @brief The initial terms of the first run.
+         */
+        Sequence::vec_t uz;
+        /**
+         * @var int64_t value
+         * @brief The target value.
+         */
+        int64_t value;
+        /**
+         * @var int64_t step
+         * @brief The step incrementing the initial terms.
+         */
+        int64_t step;
+        /**
+         * @var uint64_t count
+         * @brief The number of runs.
+         */
+        uint64_t count;
+    };
+
+    /**
+     * @brief Encode a chunk as a `Task` message.
+     *
+     * @param chunk the chunk
+     * @return      the message
+     */
+    inline core::Socket::Message encode(const Chunk& chunk)
+    {
+        core::Socket::Message ret{ Task, {} };
+
+        core::varint::putFixed(ret.payload, chunk.ordinal);
+        core::varint::putFixed(ret.payload,
+                               static_cast<uint32_t>(chunk.uz.size()));
+
+        for (const auto i : chunk.uz)
+            core::varint::putFixed(ret.payload, i);
+
+        core::varint::putFixed(ret.payload, chunk.value);
+        core::varint::putFixed(ret.payload, chunk.step);
+        core::varint::putFixed(ret.payload, chunk.count);
+
+        return ret;
+    }
+
+    /**
+     * @brief Decode a `Task` message.
+     *
+     * @exception std::runtime_error if the message is malformed
+     *
+     * @param message the message
+     * @return        the chunk
+     */
+    inline Chunk decode(const core::Socket::Message& message)
+    {
+        const auto& p = message.payload;
+        const auto malformed = [] {
+            return std::runtime_error("protocol::decode(): Malformed task.");
+        };
+
+        if ((message.type != Task) || (p.size() < 12))
+            throw malformed();
+
+        const uint32_t order = core::varint::getFixed<uint32_t>(&p[8]);
+
+        if (p.size() != 12 + (std::size_t(order) + 3) * 8)
+            throw malformed();
+
+        Chunk ret{ core::varint::getFixed<uint64_t>(&p[0]),
+                   Sequence::vec_t(order), 0, 0, 0 };
+        const unsigned char* q = &p[12];
+
+        for (auto& i : ret.uz) {
+            i = core::varint::getFixed<int64_t>(q);
+            q += 8;
+        }
+
+        ret.value = core::varint::getFixed<int64_t>(q);
+        ret.step = core::varint::getFixed<int64_t>(q + 8);
+        ret.count = core::varint::getFixed<uint64_t>(q + 16);
+
+        return ret;
+    }
+}
+
+#endif // SYRACUSE_PROTOCOL_HPP
@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/RecordFinder.hpp"
+
+#include "core/ThreadPool.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+
+namespace sequence
+{
+    namespace
+    {
+        using Record = RecordFinder::Record;
+        using size_type = RecordFinder::size_type;
+
+        bool longer(const Record& a, const Record& b)
+        {
+            return (a.cycleLen > b.cycleLen)
+                   || ((a.cycleLen == b.cycleLen) && (a.uz < b.uz));
+        }
+
+        bool higher(const Record& a, const Record& b)
+        {
+            return (a.maxTerm > b.maxTerm)
+                   || ((a.maxTerm == b.maxTerm) && (a.uz < b.uz));
+        }
+
+        // The best records, sorted from the best one.
+        template<bool (*Better)(const Record&, const Record&)>
+        class Top
+        {
+        public:
+            explicit Top(const size_type k)
+                : m_k(k), m_records()
+            {
+                m_records.reserve(static_cast<std::size_t>(k));
+            }
+
+            void add(const Record& record)
+            {
+                if ((m_records.size() == m_k)
+                    && !Better(record, m_records.back()))
+                    return;
+
+                if (m_records.size() == m_k)
+                    m_records.pop_back();
+
+                m_records.insert(std::upper_bound(m_records.begin(),
+                                                  m_records.end(), record,
+                                                  Better),
+                                 record);
+            }
+
+            void merge(const Top& other)
+            {
+                for (const auto& i : other.m_records)
+                    add(i);
+            }
+
+            std::vector<Record>& records() { return m_records; }
+        private:
+            size_type m_k;
+            std::vector<Record> m_records;
+        };
+
+        // The sieve of the runs until 1. Each method returns whether at
+        // least `k` terms of [first, last) rank before `n`.
+        class Sieve
+        {
+        public:
+            Sieve(const int64_t first, const int64_t last, const size_type k)
+                : m_first(first)
+                , m_last(last)
+                , m_k(k)
+                , m_longerLimit(std::numeric_limits<int64_t>::max())
+            {
+                // The terms found by longer() come from n, (2n - 1) / 3
+                // and n - 1, all of them at least n / 4: above this limit,
+                // each one has fewer than j doublings, and at most
+                // 3 (j - 1) + 2 = 3j - 1 terms are found, fewer than k.
+                const size_type j = k / 3;
+
+                if ((j > 0) && (j < 63) && (last > 1))
+                    m_longerLimit = 4 * ((last - 1) >> j) + 3;
+            }
+
+            bool longer(const int64_t n) const
+            {
+                if (n > m_longerLimit)
+                    return false;
+
+                // The doublings of n, then the ones of (2n - 1) / 3 and of
+                // n - 1 for n = 8k + 5, the latter being a tie.
+                size_type ret = doublings(n);
+
+                if ((ret < m_k) && third(n))
+                    ret += 1 + doublings(2 * (n / 3) + 1);
+
+                if ((ret < m_k) && (n % 8 == 5) && (n > 5)
+                    && (n - 1 >= m_first))
+                    ret += 1 + doublings(n - 1);
+
+                return ret >= m_k;
+            }
+
+            bool higher(const int64_t n) const
+            {
+                // (2n - 1) / 3 meets 2n, and thus ties with n at least.
+                if (n % 2 != 0)
+                    return (m_k == 1) && third(n);
+
+                const size_type tie = third(n) ? 1 : 0;
+
+                // There are at most as many halvings as trailing zero bits.
+                if (static_cast<size_type>(__builtin_ctzll(
+                        static_cast<unsigned long long>(n))) + tie < m_k)
+                    return false;
+
+                // Either maxTerm(n / 2) >= n, and all the halvings of n
+                // tie with it, or maxTerm(n) = n, and any odd term m > 1
+                // such that 3m + 1 > n ranks before it. (2n - 1) / 3 is
+                // one of them.
+                size_type halvings = 0;
+
+                for (int64_t i = n / 2; (i >= m_first) && (i > 1)
+                                        && (halvings < m_k); i /= 2) {
+                    ++halvings;
+
+                    if (i % 2 != 0)
+                        break;
+                }
+
+                const int64_t lo = std::max<int64_t>({ m_first,
+                                                       (n - 1) / 3 + 1, 2 });
+                const size_type odds = (lo < m_last)
+                                       ? static_cast<size_type>(m_last / 2
+                                                                - lo / 2)
+                                       : 0;
+
+                return std::min(halvings + tie, odds) >= m_k;
+            }
+        private:
+            // Whether (2n - 1) / 3, written so that it does not overflow,
+            // is an odd term of the range leading to n.
+            bool third(const int64_t n) const
+            {
+                return (n % 3 == 2) && (n > 2)
+                       && (2 * (n / 3) + 1 >= m_first);
+            }
+
+            // The number of terms 2^j x lower than last, for j > 0, up to
+            // k. Shifting x to the length of last - 1 gives the greatest
+            // j, or the one following it.
+            size_type doublings(const int64_t x) const
+            {
+                const int64_t max = m_last - 1;
+
+                if (x > max)
+                    return 0;
+
+                const int shift = bits(max) - bits(x);
+                const int ret = shift - (((x << shift) > max) ? 1 : 0);
+
+                return std::min(static_cast<size_type>(ret), m_k);
+            }
+
+            static int bits(const int64_t x)
+            {
+                return 64 - __builtin_clzll(static_cast<unsigned long long>(x));
+            }
+        private:
+            int64_t m_first;
+            int64_t m_last;
+            size_type m_k;
+            int64_t m_longerLimit;
+        };
+    }
+
+    RecordFinder::Records::~Records() = default;
+
+    RecordFinder::Records RecordFinder::find(const int64_t first,
+                                             const int64_t last) const
+    {
+        if ((first <= 0) || (m_value <= 0)) {
+            throw std::invalid_argument("RecordFinder::find(): The target "
+                                        "value and the initial terms must be "
+                                        "strictly positive.");
+        }
+
+        Top<longer> longest(m_count);
+        Top<higher> highest(m_count);
+        size_type runs = 0;
+        std::mutex mutex;
+
+        const Sieve sieve(first, last, m_count);
+        const bool sifted = m_sieve && (m_value == 1);
+        const auto n = static_cast<uint64_t>(std::max(last - first,
+                                                      int64_t(0)));
+
+        ThreadPool::global().parallelFor(0, n, 0,
+            [&](const uint64_t begin, const uint64_t end) {
+                Top<longer> localLongest(m_count);
+                Top<higher> localHighest(m_count);
+                size_type localRuns = 0;
+                Sequence::vec_t uz(1);
+
+                for (uint64_t i = begin; i < end; ++i) {
+                    uz.front() = first + static_cast<int64_t>(i);
+
+                    const bool skipLonger = !(m_statistic & CycleLen)
+                                            || (sifted
+                                                && sieve.longer(uz.front()));
+                    const bool skipHigher = !(m_statistic & MaxTerm)
+                                            || (sifted
+                                                && sieve.higher(uz.front()));
+
+                    if (skipLonger && skipHigher)
+                        continue;
+
+                    const auto ret = m_seq.doUntilWide(m_value, uz);
+                    const Record record{ uz.front(), ret.cycleLen,
+                                         ret.maxTerm };
+
+                    if (!skipLonger)
+                        localLongest.add(record);
+
+                    if (!skipHigher)
+                        localHighest.add(record);
+
+                    ++localRuns;
+                }
+
+                const std::lock_guard<std::mutex> lock(mutex);
+                longest.merge(localLongest);
+                highest.merge(localHighest);
+                runs += localRuns;
+            });
+
+        return { std::move(longest.records()), std::move(highest.records()),
+                 runs, n - runs };
+    }
+}
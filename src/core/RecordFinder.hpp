@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_RECORD_FINDER_HPP
+#define SYRACUSE_RECORD_FINDER_HPP
+
+#include "core/CollatzSequence.hpp"
+
+namespace sequence
+{
+    /**
+     * @class RecordFinder core/RecordFinder.hpp core/RecordFinder.hpp
+     * @brief A search for the initial terms of a range having the longest
+     * cycles and the highest maximum terms.
+     *
+     * Unlike a \p Sweep, no result is kept but the best ones: the range is
+     * split into chunks shared by the threads of `ThreadPool::global()`,
+     * each one keeping its own records and merging them once done. Hence,
+     * the memory used is proportional to the number of threads times the
+     * number of records.
+     *
+     * The records are ranked by decreasing statistic and, on a tie, by
+     * increasing initial term.
+     *
+     * When running until 1, the initial terms that provably cannot be
+     * among the records are not run. A term is skipped when at least as
+     * many terms of the range as records rank before it, which happens
+     * far more often for a few records of the cycle length alone, using:
+     *
+     * - \f$cycleLen(2n) = cycleLen(n) + 1\f$, and
+     *   \f$maxTerm(2n) = \max(2n, maxTerm(n))\f$;
+     * - for \f$n \equiv 2 \pmod 3\f$ and \f$n > 2\f$, the odd term
+     *   \f$m = (2n - 1) / 3 < n\f$ goes to \f$2n\f$ and then \f$n\f$, so
+     *   that its cycle is two steps longer and its maximum term is not
+     *   lower;
+     * - \f$8k + 4\f$ and \f$8k + 5\f$ both reach \f$3k + 2\f$ in four
+     *   steps, and thus have the same cycle length;
+     * - an odd term \f$m > 1\f$ meets \f$3m + 1\f$.
+     *
+     * @par Example
+     *
+     * ```cpp
+     * sequence::CollatzSequence mySeq;
+     * auto records = sequence::RecordFinder(mySeq).find(1, 1000000);
+     * records.longest.front().uz; // returns 837799
+     * ```
+     */
+    class RecordFinder
+    {
+    public:
+        /**
+         * @brief Type representing a number of runs.
+         */
+        using size_type = uint64_t;
+
+        /**
+         * @brief The statistics whose records are searched.
+         */
+        enum Statistic : unsigned int
+        {
+            /**
+             * @brief The length of the cycle.
+             */
+            CycleLen = 1,
+            /**
+             * @brief The maximum term.
+             */
+            MaxTerm = 2,
+            /**
+             * @brief Both of them.
+             */
+            Both = CycleLen | MaxTerm
+        };
+
+        /**
+         * @struct Record core/RecordFinder.hpp
+         * @brief The statistics of a run.
+         */
+        struct Record
+        {
+            /**
+             * @var int64_t uz
+             * The initial term.
+             */
+            int64_t uz;
+            /**
+             * @var std::size_t cycleLen
+             * The length of the cycle.
+             */
+            Sequence::vec_t::size_type cycleLen;
+            /**
+             * @var int128_t maxTerm
+             * The maximum term.
+             */
+            int128_t maxTerm;
+        };
+
+        /**
+         * @struct Records core/RecordFinder.hpp
+         * @brief The records found in a range.
+         */
+        struct Records
+        {
+            /**
+             * @var std::vector<Record> longest
+             * The runs having the longest cycles, the best first, if they
+             * were searched.
+             */
+            std::vector<Record> longest;
+            /**
+             * @var std::vector<Record> highest
+             * The runs having the highest maximum terms, the best first, if
+             * they were searched.
+             */
+            std::vector<Record> highest;
+            /**
+             * @var size_type runs
+             * The number of runs done.
+             */
+            size_type runs;
+            /**
+             * @var size_type skipped
+             * The number of initial terms skipped by the sieve.
+             */
+            size_type skipped;
+
+            ~Records();
+        };
+    public:
+        /**
+         * @brief Construct a search.
+         *
+         * The sequence is not copied and must outlive the search. Its jump
+         * table and its cache are used by the runs.
+         *
+         * @param seq   the sequence to run
+         * @param value run the sequence until
+         */
+        explicit RecordFinder(const CollatzSequence& seq,
+                              const int64_t value = 1)
+            : m_seq(seq)
+            , m_value(value)
+            , m_statistic(Both)
+            , m_count(1)
+            , m_sieve(true) {}
+
+        /**
+         * @brief Set the statistics whose records are searched.
+         *
+         * An initial term is only run if it may be a record of one of them,
+         * so that searching a single one skips more terms.
+         *
+         * @param statistic the statistics
+         * @return          a reference to the modified object
+         */
+        RecordFinder& withStatistic(const Statistic statistic)
+        {
+            m_statistic = statistic;
+            return *this;
+        }
+
+        /**
+         * @brief Set the number of records of each statistic.
+         *
+         * @param k the number of records, or 0 for a single one
+         * @return  a reference to the modified object
+         */
+        RecordFinder& withCount(const size_type k)
+        {
+            m_count = (k == 0) ? 1 : k;
+            return *this;
+        }
+        /**
+         * @brief Set whether the initial terms that cannot be records are
+         * skipped.
+         *
+         * The sieve is only used when running until 1.
+         *
+         * @param sieve `true` to skip them
+         * @return      a reference to the modified object
+         */
+        RecordFinder& withSieve(const bool sieve)
+        {
+            m_sieve = sieve;
+            return *this;
+        }
+
+        /**
+         * @brief Get the statistics whose records are searched.
+         *
+         * @return the statistics
+         */
+        Statistic statistic() const { return m_statistic; }
+        /**
+         * @brief Get the number of records of each statistic.
+         *
+         * @return the number of records
+         */
+        size_type count() const { return m_count; }
+        /**
+         * @brief Get whether the initial terms that cannot be records are
+         * skipped.
+         *
+         * @return `true` if they are skipped
+         */
+        bool sieve() const { return m_sieve; }
+
+        /**
+         * @brief Run the search over the initial terms of \f$[first,
+         * last)\f$.
+         *
+         * @warning
+         * \p first and \p value must be strictly positive, or otherwise an
+         * `std::invalid_argument` will be thrown.
+         *
+         * @warning
+         * This method waits for the threads of `ThreadPool::global()`, and
+         * thus must not be called from one of them.
+         *
+         * @param first the first initial term
+         * @param last  the initial term following the last one
+         * @return      the records
+         */
+        Records find(const int64_t first, const int64_t last) const;
+    private:
+        const CollatzSequence& m_seq;
+        int64_t m_value;
+        Statistic m_statistic;
+        size_type m_count;
+        bool m_sieve;
+    };
+}
+
+#endif // SYRACUSE_RECORD_FINDER_HPP
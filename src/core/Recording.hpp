@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_RECORDING_HPP
+#define SYRACUSE_RECORDING_HPP
+
+#include "core/Trajectory.hpp"
+
+namespace sequence
+{
+    /**
+     * @brief Namespace providing the recording policies of the run loops.
+     *
+     * A loop is a template over its policy, to which each term or step is
+     * given: `push()` for the terms of `Sequence::doUntil()`, `evens()`
+     * and `odd()` for the steps of `CollatzSequence::doUntilWide()`. With
+     * \p None, the calls are empty and inlined, so that the loop compiles
+     * to the one without any recording. \p enabled tells the loops that may
+     * skip some steps, e.g. by a jump, whether they must not.
+     */
+    namespace recording
+    {
+        struct None
+        {
+            static constexpr bool enabled = false;
+
+            void push(const int64_t) {}
+            template<typename Int>
+            void evens(const Int, const Trajectory::size_type) {}
+            template<typename Int>
+            void odd(const Int) {}
+        };
+
+        struct Terms
+        {
+            static constexpr bool enabled = true;
+
+            void push(const int64_t term) { terms.push_back(term); }
+
+            Sequence::vec_t& terms;
+        };
+
+        struct Parity
+        {
+            static constexpr bool enabled = true;
+
+            template<typename Int>
+            void evens(const Int term, const Trajectory::size_type count)
+            {
+                trajectory.pushEvens(term, count);
+            }
+
+            template<typename Int>
+            void odd(const Int term) { trajectory.pushOdd(term); }
+
+            Trajectory& trajectory;
+        };
+    }
+}
+
+#endif // SYRACUSE_RECORDING_HPP
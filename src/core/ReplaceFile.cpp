@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/ReplaceFile.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include <unistd.h>
+
+namespace core
+{
+    bool replaceFile(const std::string& path,
+                     const std::initializer_list<Bytes> parts,
+                     const std::string& where, const accept_t& accept)
+    {
+        const auto error = [&](const std::string& file, const int err) {
+            return std::runtime_error(where + ": " + file + ": "
+                                      + std::strerror(err));
+        };
+
+        const std::string tmp = path + ".tmp";
+        std::FILE* file = std::fopen(tmp.c_str(), "wb");
+        bool ok = (file != nullptr);
+
+        for (const auto& i : parts)
+            ok = ok && (std::fwrite(i.data, 1, i.size, file) == i.size);
+
+        ok = ok && (std::fflush(file) == 0) && (::fsync(::fileno(file)) == 0);
+        int err = errno;
+
+        if ((file != nullptr) && (std::fclose(file) != 0) && ok) {
+            ok = false;
+            err = errno;
+        }
+
+        if (!ok) {
+            if (file != nullptr)
+                std::remove(tmp.c_str());
+
+            throw error(tmp, err);
+        }
+
+        if (accept && !accept(tmp)) {
+            std::remove(tmp.c_str());
+            return false;
+        }
+
+        if (std::rename(tmp.c_str(), path.c_str()) != 0)
+            throw error(path, errno);
+
+        return true;
+    }
+}
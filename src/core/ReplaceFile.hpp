@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_REPLACE_FILE_HPP
+#define SYRACUSE_REPLACE_FILE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <string>
+
+namespace core
+{
+    /**
+     * @struct Bytes core/ReplaceFile.hpp
+     * @brief A run of bytes written by `replaceFile()`.
+     */
+    struct Bytes
+    {
+        /**
+         * @var const void* data
+         * The first byte.
+         */
+        const void* data;
+        /**
+         * @var std::size_t size
+         * The number of bytes.
+         */
+        std::size_t size;
+    };
+
+    /**
+     * @brief Type of the function checking a file before it replaces
+     * another one.
+     *
+     * It is given the path of the new file, and returns `false` to keep the
+     * previous one.
+     */
+    using accept_t = std::function<bool(const std::string&)>;
+
+    /**
+     * @brief Replace a file at once.
+     *
+     * The bytes are written to a temporary file next to \p path, made
+     * durable and renamed over \p path, so that an interruption leaves
+     * either the previous file or the new one, never a half-written one.
+     *
+     * @exception std::runtime_error if the file cannot be written, the
+     * message starting with \p where and the path
+     *
+     * @param path   the path of the file
+     * @param parts  the bytes, written one after another
+     * @param where  the method writing the file, starting the messages of
+     *               the errors
+     * @param accept the function checking the new file, or `nullptr`
+     * @return       `false` if the new file has been refused by \p accept,
+     *               the previous one then being left untouched
+     */
+    bool replaceFile(const std::string& path,
+                     const std::initializer_list<Bytes> parts,
+                     const std::string& where,
+                     const accept_t& accept = nullptr);
+}
+
+#endif // SYRACUSE_REPLACE_FILE_HPP
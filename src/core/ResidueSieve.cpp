@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/ResidueSieve.hpp"
+
+#include "core/ReplaceFile.hpp"
+#include "core/Varint.hpp"
+
+#include <stdexcept>
+
+namespace sequence
+{
+    namespace
+    {
+        // One byte at least, so that the bits of the classes lower than 8
+        // have somewhere to live.
+        std::size_t length(const unsigned int bits)
+        {
+            return (bits < 3) ? 1 : (std::size_t(1) << (bits - 3));
+        }
+    }
+
+    ResidueSieve::ResidueSieve(const unsigned int bits)
+        : m_bits(bits)
+        , m_mask(0)
+        , m_survivors(0)
+        , m_owned()
+        , m_file()
+        , m_data(nullptr)
+    {
+        if ((bits == 0) || (bits > maxBits)) {
+            throw std::invalid_argument("ResidueSieve::ResidueSieve(): The "
+                                        "number of bits must be between 1 "
+                                        "and 32.");
+        }
+
+        m_mask = (uint64_t(1) << bits) - 1;
+        m_owned.assign(length(bits), 0);
+        m_data = m_owned.data();
+        build(0, 0, 0, 1);
+    }
+
+    ResidueSieve::ResidueSieve(const std::string& path)
+        : m_bits(0)
+        , m_mask(0)
+        , m_survivors(0)
+        , m_owned()
+        , m_file()
+        , m_data(nullptr)
+    {
+        m_file = core::MappedFile(path, "ResidueSieve::ResidueSieve()");
+        m_file.checkHeader(magic, version, headerSize, "Not a sieve file.");
+        m_bits = core::varint::getFixed<uint32_t>(m_file.data() + 12);
+
+        if ((m_bits == 0) || (m_bits > maxBits))
+            throw m_file.error("Invalid number of bits.");
+
+        if (m_file.size() - headerSize != length(m_bits))
+            throw m_file.error("Truncated sieve.");
+
+        m_mask = (uint64_t(1) << m_bits) - 1;
+        m_data = m_file.data() + headerSize;
+
+        for (std::size_t i = 0; i < length(m_bits); ++i) {
+            m_survivors +=
+                static_cast<size_type>(__builtin_popcount(m_data[i]));
+        }
+    }
+
+    void ResidueSieve::save(const std::string& path) const
+    {
+        using core::varint::putFixed;
+
+        std::vector<unsigned char> header(magic, magic + 8);
+        putFixed<uint32_t>(header, version);
+        putFixed<uint32_t>(header, m_bits);
+
+        core::replaceFile(path, { { header.data(), header.size() },
+                                  { m_data, length(m_bits) } },
+                          "ResidueSieve::save()");
+    }
+
+    // `term` is T^depth(b) and `power` is 3^c, so that the initial terms
+    // 2^depth m + b reach 3^c m + term.
+    void ResidueSieve::build(const unsigned int depth, const uint64_t b,
+                             const uint64_t term, const uint64_t power)
+    {
+        // From n >= 2^k on, m >= 2^(k - depth): the whole class falls if
+        // its lowest initial term does.
+        if ((power < (uint64_t(1) << depth))
+            && ((uint64_t(1) << m_bits) - (power << (m_bits - depth)) + b
+                > term)) {
+            return;
+        }
+
+        if (depth == m_bits) {
+            m_owned[b / 8] = static_cast<unsigned char>(m_owned[b / 8]
+                                                        | (1 << (b % 8)));
+            ++m_survivors;
+            return;
+        }
+
+        // The next bit of n is the parity of m, which adds 3^c to the term.
+        for (const uint64_t bit : { uint64_t(0), uint64_t(1) }) {
+            const uint64_t t = term + bit * power;
+            const uint64_t child = b | (bit << depth);
+
+            if (t % 2 != 0)
+                build(depth + 1, child, (3 * t + 1) / 2, 3 * power);
+            else
+                build(depth + 1, child, t / 2, power);
+        }
+    }
+}
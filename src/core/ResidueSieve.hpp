@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_RESIDUE_SIEVE_HPP
+#define SYRACUSE_RESIDUE_SIEVE_HPP
+
+#include "config-syracuse.hpp"
+#include "core/MappedFile.hpp"
+#include "core/Sequence.hpp"
+
+#include <string>
+
+namespace sequence
+{
+    /**
+     * @class ResidueSieve core/ResidueSieve.hpp core/ResidueSieve.hpp
+     * @brief A sieve of the initial terms of the Syracuse sequence that
+     * provably fall below themselves, from their low bits alone.
+     *
+     * Writing an initial term \f$n = 2^k a + b\f$ with \f$b < 2^k\f$, the
+     * \f$j \leq k\f$ first steps of the shortcut form lead to
+     * \f$3^c 2^{k - j} a + T^j(b)\f$, where \f$c\f$ is the number of odd
+     * steps. If \f$3^c < 2^j\f$ and this term is lower than \f$n\f$ for
+     * \f$a = 1\f$, it is so for any \f$a \geq 1\f$: all the initial terms
+     * \f$n \geq 2^k\f$ of the residue class \f$b\f$ fall below themselves,
+     * and thus reach 1 if all the lower ones do.
+     *
+     * The sieve keeps one bit per residue class, set if the class
+     * survives. Less than 10 % of the classes survive from \f$k = 8\f$ on,
+     * less than 2 % from \f$k = 24\f$ on and less than 1 % for
+     * \f$k = 32\f$. The classes are explored as
+     * a tree of the low bits, whose branches stop as soon as they fall, so
+     * that building the sieve costs far less than \f$k 2^k\f$ steps.
+     *
+     * @par Format
+     * A sieve can be saved to a file and mapped in memory rather than
+     * built again. The file starts with a header of 16 bytes:
+     *
+     * | Offset | Type       | Content                     |
+     * |--------|------------|-----------------------------|
+     * | 0      | `char[8]`  | `"SYRSIEVE"`                |
+     * | 8      | `uint32_t` | the version, currently 1    |
+     * | 12     | `uint32_t` | the number \f$k\f$ of bits  |
+     *
+     * The bits follow, the bit of the class \f$b\f$ being the bit
+     * \f$b \bmod 8\f$ of the byte \f$\lfloor b / 8 \rfloor\f$.
+     *
+     * @par Example
+     *
+     * ```cpp
+     * sequence::ResidueSieve sieve(16);
+     * sieve.survives(27);    // returns true, 27 climbing up to 9232
+     * sieve.survives(65537); // returns false, as 65537 = 1 mod 4
+     * ```
+     */
+    class ResidueSieve
+    {
+    public:
+        /**
+         * @brief Type representing a number of residue classes.
+         */
+        using size_type = uint64_t;
+
+        /**
+         * @brief The greatest number of bits of a sieve, which then takes
+         * 512 MiB.
+         */
+        static constexpr unsigned int maxBits = 32;
+        /**
+         * @brief The number of bytes of the header of a file.
+         */
+        static constexpr std::size_t headerSize = 16;
+        /**
+         * @brief The magic number starting a file.
+         */
+        static constexpr char magic[9] = "SYRSIEVE";
+        /**
+         * @brief The version of the format of the files.
+         */
+        static constexpr uint32_t version = 1;
+    public:
+        /**
+         * @brief Build the sieve.
+         *
+         * @warning
+         * \p bits must be between 1 and \p maxBits, or otherwise an
+         * `std::invalid_argument` will be thrown.
+         *
+         * @param bits the number \f$k\f$ of low bits considered
+         */
+        explicit ResidueSieve(const unsigned int bits = SYRACUSE_SIEVE_BITS);
+        /**
+         * @brief Map a sieve saved by `save()`.
+         *
+         * @exception std::runtime_error if the file cannot be mapped or is
+         * not a valid sieve file
+         *
+         * @param path the path of the file
+         */
+        explicit ResidueSieve(const std::string& path);
+        ResidueSieve(const ResidueSieve&) = delete;
+        ResidueSieve& operator=(const ResidueSieve&) = delete;
+
+        /**
+         * @brief Get the number of low bits considered.
+         *
+         * @return the number \f$k\f$ of bits
+         */
+        unsigned int bits() const { return m_bits; }
+        /**
+         * @brief Get the number of residue classes surviving the sieve.
+         *
+         * @return the number of classes, out of \f$2^k\f$
+         */
+        size_type survivors() const { return m_survivors; }
+        /**
+         * @brief Check whether an initial term survives the sieve.
+         *
+         * @warning
+         * A term lower than \f$2^k\f$ may not fall below itself even
+         * though its class does not survive, e.g. 1.
+         *
+         * @param n the initial term
+         * @return  `false` if \p n, being at least \f$2^k\f$, provably
+         *          falls below itself
+         */
+        inline bool survives(const int64_t n) const;
+
+        /**
+         * @brief Save the sieve.
+         *
+         * The file is replaced at once, so that an interruption leaves the
+         * previous one intact.
+         *
+         * @exception std::runtime_error if the file cannot be written
+         *
+         * @param path the path of the file
+         */
+        void save(const std::string& path) const;
+    private:
+        void build(const unsigned int depth, const uint64_t b,
+                   const uint64_t term, const uint64_t power);
+    private:
+        unsigned int m_bits;
+        uint64_t m_mask;
+        size_type m_survivors;
+        std::vector<unsigned char> m_owned;
+        core::MappedFile m_file;
+        const unsigned char* m_data;
+    };
+
+    inline bool ResidueSieve::survives(const int64_t n) const
+    {
+        const auto b = static_cast<uint64_t>(n) & m_mask;
+        return (m_data[b / 8] >> (b % 8)) & 1;
+    }
+}
+
+#endif // SYRACUSE_RESIDUE_SIEVE_HPP
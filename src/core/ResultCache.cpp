@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/ResultCache.hpp"
+
+#include "core/Topology.hpp"
+
+#include <climits>
+#include <new>
+#include <vector>
+
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace sequence
+{
+    namespace
+    {
+        // Spreads the pages of a mapping over the nodes of the machine,
+        // through the system call so that libnuma is not needed.
+        void interleave(void* data, const std::size_t length)
+        {
+            const core::Topology& topology = core::Topology::system();
+
+            if (topology.size() < 2)
+                return;
+
+            constexpr std::size_t bits = sizeof(unsigned long) * CHAR_BIT;
+            std::vector<unsigned long> mask;
+
+            for (std::size_t i = 0; i < topology.size(); ++i) {
+                const unsigned int id = topology.id(i);
+
+                if (mask.size() <= id / bits)
+                    mask.resize(id / bits + 1);
+
+                mask[id / bits] |= 1ul << (id % bits);
+            }
+
+            // The pages are left to the first-touch policy on failure.
+            ::syscall(SYS_mbind, data, length, MPOL_INTERLEAVE, mask.data(),
+                      mask.size() * bits + 1, 0);
+        }
+    }
+
+    ResultCache::ResultCache(const int64_t value, const int64_t limit)
+        : m_value(value)
+        , m_limit(std::max<int64_t>(limit, 0))
+        , m_slots(nullptr)
+    {
+        // The pages of an anonymous mapping read as zero, i.e. as empty
+        // slots, and are only allocated by the first write.
+        void* data = ::mmap(nullptr, length(), PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (data == MAP_FAILED)
+            throw std::bad_alloc();
+
+        interleave(data, length());
+        m_slots = static_cast<Slot*>(data);
+    }
+
+    ResultCache::~ResultCache()
+    {
+        ::munmap(m_slots, length());
+    }
+
+    std::size_t ResultCache::length() const
+    {
+        return std::max<std::size_t>(
+            static_cast<std::size_t>(m_limit) * sizeof(Slot), 1);
+    }
+}
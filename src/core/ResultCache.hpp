@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_RESULT_CACHE_HPP
+#define SYRACUSE_RESULT_CACHE_HPP
+
+#include "core/Metrics.hpp"
+#include "core/Sequence.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+namespace sequence
+{
+    /**
+     * @class ResultCache core/ResultCache.hpp core/ResultCache.hpp
+     * @brief A cache of the results of `doUntil()` for the low initial
+     * terms.
+     *
+     * The results of the initial terms lower than a given limit are stored
+     * in a dense array, so that a run meeting one of these terms can stop
+     * early. The cache is lock-free: since a result never changes, several
+     * threads writing the same slot write the same values.
+     *
+     * On a machine of several NUMA nodes, the pages of the array are split
+     * between the nodes in turn rather than given to the node writing them
+     * first, so that the lookups of all the threads share the bandwidth of
+     * the nodes. Each result is stored once, and is found by the threads of
+     * every node.
+     *
+     * @par Example
+     *
+     * ```cpp
+     * auto cache = std::make_shared<sequence::ResultCache>(1, 1 << 20);
+     * sequence::CollatzSequence mySeq(1);
+     * mySeq.withCache(cache).loadNUntil(1000000, 1);
+     * ```
+     *
+     * @warning
+     * A cache must only be shared by sequences using the same recurrence
+     * relation of order 1.
+     */
+    class ResultCache
+    {
+    public:
+        /**
+         * @brief Type containing the statistics of a run.
+         */
+        using Result = Sequence::Result;
+    public:
+        /**
+         * @brief Construct an empty cache.
+         *
+         * The cache takes 16 bytes per term lower than \p limit, the pages
+         * being only allocated once written.
+         *
+         * @exception std::bad_alloc if the array cannot be mapped
+         *
+         * @param value the target value of the cached runs
+         * @param limit the term from which the results are not cached
+         */
+        ResultCache(const int64_t value, const int64_t limit);
+        ResultCache(const ResultCache&) = delete;
+        ResultCache& operator=(const ResultCache&) = delete;
+        /**
+         * @brief Unmap the array.
+         */
+        ~ResultCache();
+
+        /**
+         * @brief Get the target value of the cached runs.
+         *
+         * @return the target value
+         */
+        int64_t value() const { return m_value; }
+        /**
+         * @brief Get the term from which the results are not cached.
+         *
+         * @return the limit
+         */
+        int64_t limit() const { return m_limit; }
+
+        /**
+         * @brief Look for the result of a run.
+         *
+         * @param uz     the initial term
+         * @param result the found result
+         * @return       `true` if a result has been found
+         */
+        inline bool find(const int64_t uz, Result& result) const;
+        /**
+         * @brief Store the result of a run.
+         *
+         * The result is ignored if the initial term is not cached.
+         *
+         * @param uz     the initial term
+         * @param result the result
+         */
+        inline void insert(const int64_t uz, const Result& result);
+    private:
+        struct Slot
+        {
+            std::atomic<uint64_t> cycleLen;
+            std::atomic<int64_t> maxTerm;
+        };
+    private:
+        std::size_t length() const;
+    private:
+        int64_t m_value;
+        int64_t m_limit;
+        Slot* m_slots;
+    };
+
+    inline bool ResultCache::find(const int64_t uz, Result& result) const
+    {
+        if ((uz < 0) || (uz >= m_limit))
+            return false;
+
+        const Slot& slot = m_slots[static_cast<std::size_t>(uz)];
+
+        // The length of the cycle is stored shifted by one, so that zero
+        // means an empty slot.
+        const uint64_t cycleLen = slot.cycleLen.load(std::memory_order_acquire);
+
+        if (cycleLen == 0) {
+            Metrics::add(Metrics::CacheMisses, 1);
+            return false;
+        }
+
+        Metrics::add(Metrics::CacheHits, 1);
+        result.cycleLen = cycleLen - 1;
+        result.maxTerm = slot.maxTerm.load(std::memory_order_relaxed);
+        return true;
+    }
+
+    inline void ResultCache::insert(const int64_t uz, const Result& result)
+    {
+        if ((uz < 0) || (uz >= m_limit))
+            return;
+
+        Slot& slot = m_slots[static_cast<std::size_t>(uz)];
+
+        slot.maxTerm.store(result.maxTerm, std::memory_order_relaxed);
+        slot.cycleLen.store(result.cycleLen + 1, std::memory_order_release);
+    }
+}
+
+#endif // SYRACUSE_RESULT_CACHE_HPP
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/ResultFile.hpp"
+
+#include "core/ResultTable.hpp"
+#include "core/Varint.hpp"
+
+namespace sequence
+{
+    ResultFile::ResultFile(const std::string& path)
+        : m_file(path, "ResultFile::ResultFile()")
+        , m_uz()
+        , m_value(0)
+        , m_step(0)
+        , m_size(0)
+        , m_blockSize(0)
+        , m_index(nullptr)
+    {
+        using core::varint::getFixed;
+
+        m_file.checkHeader(magic, version, headerSize, "Not a result file.");
+
+        const unsigned char* const data = m_file.data();
+        const auto order = getFixed<uint32_t>(data + 12);
+        m_value = getFixed<int64_t>(data + 16);
+        m_step = getFixed<int64_t>(data + 24);
+        m_size = getFixed<uint64_t>(data + 32);
+        m_blockSize = getFixed<uint32_t>(data + 40);
+        const auto indexOffset = getFixed<uint64_t>(data + 48);
+
+        if ((order == 0) || (m_file.size() - headerSize) / 8 < order)
+            throw m_file.error("Truncated header.");
+
+        for (std::size_t i = 0; i < order; ++i)
+            m_uz.push_back(getFixed<int64_t>(data + headerSize + 8 * i));
+
+        const size_type blocks =
+            (m_blockSize == 0) ? 0 : (m_size + m_blockSize - 1) / m_blockSize;
+
+        if (((m_size != 0) && (m_blockSize == 0))
+            || (indexOffset > m_file.size())
+            || ((m_file.size() - indexOffset) / 16 < blocks)) {
+            throw m_file.error("Truncated block index.");
+        }
+
+        m_index = data + indexOffset;
+    }
+
+    ResultFile::~ResultFile() = default;
+
+    ResultFile::vec_t ResultFile::uz(const size_type i) const
+    {
+        vec_t ret = m_uz;
+        const auto shift = static_cast<int64_t>(i) * m_step;
+
+        for (auto& j : ret)
+            j += shift;
+
+        return ret;
+    }
+
+    template<typename Fn>
+    void ResultFile::decode(const size_type block, const size_type count,
+                            const Fn& fn) const
+    {
+        using core::varint::get;
+        using core::varint::getFixed;
+        using core::varint::unzigzag;
+
+        const auto cyclesOffset = getFixed<uint64_t>(m_index + 16 * block);
+        const auto termsOffset = getFixed<uint64_t>(m_index + 16 * block + 8);
+
+        if ((cyclesOffset > termsOffset) || (termsOffset > m_file.size())) {
+            throw std::runtime_error("ResultFile::decode(): The block index "
+                                     "is corrupted.");
+        }
+
+        const unsigned char* cycles = m_file.data() + cyclesOffset;
+        const unsigned char* const cyclesEnd = m_file.data() + termsOffset;
+        const unsigned char* terms = cyclesEnd;
+        const unsigned char* const termsEnd = m_file.data() + m_file.size();
+
+        int128_t cycleLen = 0;
+        int64_t uz = m_uz.front() + static_cast<int64_t>(block * m_blockSize)
+                                    * m_step;
+
+        for (size_type i = 0; i < count; ++i) {
+            cycleLen += unzigzag(get(cycles, cyclesEnd));
+            const int128_t maxTerm = uz + unzigzag(get(terms, termsEnd));
+
+            fn(i, WideResult{ static_cast<std::size_t>(cycleLen), maxTerm });
+            uz += m_step;
+        }
+    }
+
+    ResultFile::WideResult ResultFile::operator[](const size_type i) const
+    {
+        if (i >= m_size)
+            throw std::out_of_range("ResultFile::operator[](): No such run.");
+
+        WideResult ret = {};
+
+        decode(i / m_blockSize, i % m_blockSize + 1,
+               [&](const size_type, const WideResult& result) {
+                   ret = result;
+               });
+
+        return ret;
+    }
+
+    Ref<ResultTable> ResultFile::read(const size_type first,
+                                      const size_type n) const
+    {
+        if ((first > m_size) || (n > m_size - first))
+            throw std::out_of_range("ResultFile::read(): No such runs.");
+
+        auto ret = std::make_shared<ResultTable>(uz(first), m_step, n);
+        const size_type last = first + n;
+
+        // The number of runs per block of an empty file may be zero.
+        if (n == 0)
+            return ret;
+
+        for (size_type block = first / m_blockSize; block * m_blockSize < last;
+             ++block) {
+            const size_type begin = block * m_blockSize;
+            const size_type count = std::min(m_blockSize, last - begin);
+
+            decode(block, count,
+                   [&](const size_type i, const WideResult& result) {
+                       if (begin + i >= first)
+                           ret->set(begin + i - first, result);
+                   });
+        }
+
+        return ret;
+    }
+}
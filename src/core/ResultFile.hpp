@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_RESULT_FILE_HPP
+#define SYRACUSE_RESULT_FILE_HPP
+
+#include "core/MappedFile.hpp"
+#include "core/Sequence.hpp"
+
+namespace sequence
+{
+    class ResultTable;
+
+    /**
+     * @class ResultFile core/ResultFile.hpp core/ResultFile.hpp
+     * @brief A reader of the binary files written by `BinaryWriter`.
+     *
+     * The file is mapped in memory rather than read, so that opening it
+     * costs nothing whatever its size, and only the blocks holding the
+     * requested runs are decoded.
+     *
+     * @par Format
+     * All the integers are little-endian. The file starts with a header of
+     * 64 bytes:
+     *
+     * | Offset | Type       | Content                                   |
+     * |--------|------------|-------------------------------------------|
+     * | 0      | `char[8]`  | `"SYRACUSE"`                              |
+     * | 8      | `uint32_t` | the version, currently 1                  |
+     * | 12     | `uint32_t` | the number \f$k\f$ of initial terms       |
+     * | 16     | `int64_t`  | the target value                          |
+     * | 24     | `int64_t`  | the step incrementing the initial terms   |
+     * | 32     | `uint64_t` | the number of runs                        |
+     * | 40     | `uint32_t` | the number of runs per block              |
+     * | 48     | `uint64_t` | the offset of the block index             |
+     *
+     * The other bytes are zero. The \f$k\f$ initial terms of the first run
+     * follow, as `int64_t`, and then the blocks. Each block holds two
+     * columns of varints (see `core::varint`):
+     *
+     * - the lengths of the cycles, each one as the zigzag-encoded
+     *   difference with the previous one of the block;
+     * - the maximum terms, each one as the zigzag-encoded difference with
+     *   the first initial term of its run, which is often zero.
+     *
+     * The block index ends the file. For each block, it holds two
+     * `uint64_t`: the offsets of the two columns.
+     */
+    class ResultFile
+    {
+    public:
+        /**
+         * @brief Type representing the ordinal of a run.
+         */
+        using size_type = uint64_t;
+        /**
+         * @brief Type representing a vector of terms.
+         */
+        using vec_t = Sequence::vec_t;
+        /**
+         * @brief Type containing the statistics of a run.
+         */
+        using WideResult = Sequence::WideResult;
+    public:
+        /**
+         * @brief Map a file.
+         *
+         * @exception std::runtime_error if the file cannot be mapped or is
+         * not a valid result file
+         *
+         * @param path the path of the file
+         */
+        explicit ResultFile(const std::string& path);
+        ResultFile(const ResultFile&) = delete;
+        ResultFile& operator=(const ResultFile&) = delete;
+        /**
+         * @brief Unmap the file.
+         */
+        ~ResultFile();
+
+        /**
+         * @brief Get the number of runs.
+         *
+         * @return the number of runs
+         */
+        size_type size() const { return m_size; }
+        /**
+         * @brief Get the target value of the runs.
+         *
+         * @return the target value
+         */
+        int64_t value() const { return m_value; }
+        /**
+         * @brief Get the step incrementing the initial terms.
+         *
+         * @return the step
+         */
+        int64_t step() const { return m_step; }
+        /**
+         * @brief Get the number of runs per block.
+         *
+         * @return the number of runs
+         */
+        size_type blockSize() const { return m_blockSize; }
+        /**
+         * @brief Get the initial terms of the first run.
+         *
+         * @return the initial terms
+         */
+        const vec_t& uz() const { return m_uz; }
+        /**
+         * @brief Get the initial terms of a run.
+         *
+         * @param i the ordinal of the run
+         * @return  the initial terms
+         */
+        vec_t uz(const size_type i) const;
+
+        /**
+         * @brief Get the statistics of a run.
+         *
+         * Only the block holding the run is decoded, up to the run.
+         *
+         * @exception std::out_of_range if there is no such run
+         * @exception std::runtime_error if the block is corrupted
+         *
+         * @param i the ordinal of the run
+         * @return  the statistics
+         */
+        WideResult operator[](const size_type i) const;
+        /**
+         * @brief Load consecutive runs into a table.
+         *
+         * @exception std::out_of_range if the runs exceed the file
+         * @exception std::runtime_error if a block is corrupted
+         *
+         * @param first the ordinal of the first run
+         * @param n     the number of runs
+         * @return      a pointer to a table whose first initial terms are
+         *              the ones of the run \p first
+         */
+        Ref<ResultTable> read(const size_type first, const size_type n) const;
+
+        /**
+         * @brief Get the greatest size of a valid file.
+         *
+         * A varint takes at most 19 bytes, and each block at least one run.
+         *
+         * @param runs  the number of runs
+         * @param order the number \f$k\f$ of initial terms
+         * @return      the size in bytes
+         */
+        static constexpr uint64_t maxSize(const size_type runs,
+                                          const std::size_t order)
+        {
+            return headerSize + 8 * order + runs * (2 * 19 + 16);
+        }
+    public:
+        /**
+         * @brief The first bytes of the files.
+         */
+        static constexpr char magic[9] = "SYRACUSE";
+        /**
+         * @brief The version of the format.
+         */
+        static constexpr uint32_t version = 1;
+        /**
+         * @brief The size of the header, without the initial terms.
+         */
+        static constexpr std::size_t headerSize = 64;
+    private:
+        template<typename Fn>
+        void decode(const size_type block, const size_type count,
+                    const Fn& fn) const;
+    private:
+        core::MappedFile m_file;
+        vec_t m_uz;
+        int64_t m_value;
+        int64_t m_step;
+        size_type m_size;
+        size_type m_blockSize;
+        const unsigned char* m_index;
+    };
+}
+
+#endif // SYRACUSE_RESULT_FILE_HPP
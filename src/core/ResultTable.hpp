@@ -0,0 +1,278 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_RESULT_TABLE_HPP
+#define SYRACUSE_RESULT_TABLE_HPP
+
+#include "core/FirstTouchAllocator.hpp"
+#include "core/Sequence.hpp"
+
+#include <limits>
+#include <map>
+#include <mutex>
+
+namespace sequence
+{
+    /**
+     * @class ResultTable core/ResultTable.hpp core/ResultTable.hpp
+     * @brief A table storing the results of runs whose initial terms
+     * follow an arithmetic progression.
+     *
+     * The initial terms of the run of ordinal \f$i\f$ are the first ones
+     * plus \f$i \times step\f$, so that they do not need to be stored. The
+     * statistics are stored column by column, using 16 bytes per run.
+     * The columns are not written until the runs are set, so that their
+     * pages land on the NUMA nodes of the threads setting them.
+     *
+     * The few maximum terms exceeding 64 bits are kept aside: the column
+     * holds `INT64_MAX` for them, and `wideMaxTerm()` gives their actual
+     * value.
+     *
+     * @par Example
+     *
+     * ```cpp
+     * auto table = mySeq.loadNUntil(100, 1);
+     *
+     * for (std::size_t i = 0; i < table->size(); ++i)
+     *     std::cout << table->uz(i)[0] << ": " << table->cycleLen(i) << '\n';
+     * ```
+     */
+    class ResultTable
+    {
+    public:
+        /**
+         * @brief Type representing the ordinal of a run.
+         */
+        using size_type = std::size_t;
+        /**
+         * @brief Type representing a vector of terms.
+         */
+        using vec_t = Sequence::vec_t;
+        /**
+         * @brief Type containing the statistics of a run.
+         */
+        using Result = Sequence::Result;
+        /**
+         * @brief Type containing the statistics of a run whose maximum term
+         * may exceed 64 bits.
+         */
+        using WideResult = Sequence::WideResult;
+        /**
+         * @brief Type representing a column of statistics.
+         */
+        template<typename T>
+        using column_t = std::vector<T, core::FirstTouchAllocator<T>>;
+    public:
+        /**
+         * @brief Construct a table whose statistics are to be set.
+         *
+         * @param uz   the initial terms of the first run
+         * @param step the step incrementing the initial terms
+         * @param n    the number of runs
+         */
+        ResultTable(const vec_t& uz, const int64_t step, const size_type n)
+            : m_uz(uz), m_step(step), m_cycleLens(n), m_maxTerms(n) {}
+
+        /**
+         * @brief Reuse the table for other runs.
+         *
+         * The storage of the columns is kept, so that a table of the same
+         * size allocates nothing. The statistics are unspecified until set.
+         *
+         * @param uz the initial terms of the first run
+         * @param n  the number of runs
+         */
+        inline void reset(const vec_t& uz, const size_type n);
+
+        /**
+         * @brief Get the number of runs.
+         *
+         * @return the number of runs
+         */
+        size_type size() const { return m_cycleLens.size(); }
+        /**
+         * @brief Get the step incrementing the initial terms.
+         *
+         * @return the step
+         */
+        int64_t step() const { return m_step; }
+        /**
+         * @brief Get the initial terms of the first run.
+         *
+         * @return the initial terms
+         */
+        const vec_t& uz() const { return m_uz; }
+        /**
+         * @brief Get the initial terms of a run.
+         *
+         * @param i the ordinal of the run
+         * @return  the initial terms
+         */
+        inline vec_t uz(const size_type i) const;
+
+        /**
+         * @brief Get the statistics of a run.
+         *
+         * @param i the ordinal of the run
+         * @return  the statistics
+         */
+        Result operator[](const size_type i) const
+        {
+            return { m_cycleLens[i], m_maxTerms[i] };
+        }
+        /**
+         * @brief Get the length of the cycle of a run.
+         *
+         * @param i the ordinal of the run
+         * @return  the length of the cycle
+         */
+        vec_t::size_type cycleLen(const size_type i) const
+        {
+            return m_cycleLens[i];
+        }
+        /**
+         * @brief Get the maximum term of a run.
+         *
+         * @param i the ordinal of the run
+         * @return  the maximum term
+         */
+        int64_t maxTerm(const size_type i) const { return m_maxTerms[i]; }
+        /**
+         * @brief Get the maximum term of a run, even if it exceeds 64
+         * bits.
+         *
+         * @param i the ordinal of the run
+         * @return  the maximum term
+         */
+        inline int128_t wideMaxTerm(const size_type i) const;
+        /**
+         * @brief Check whether the maximum term of a run exceeds 64 bits.
+         *
+         * @param i the ordinal of the run
+         * @return  `true` if only `wideMaxTerm()` gives the maximum term
+         */
+        inline bool isWide(const size_type i) const;
+        /**
+         * @brief Set the statistics of a run.
+         *
+         * @note
+         * Distinct runs can be set concurrently.
+         *
+         * @param i      the ordinal of the run
+         * @param result the statistics
+         */
+        void set(const size_type i, const Result& result)
+        {
+            m_cycleLens[i] = result.cycleLen;
+            m_maxTerms[i] = result.maxTerm;
+        }
+        /**
+         * @brief Set the statistics of a run whose maximum term may exceed
+         * 64 bits.
+         *
+         * @note
+         * Distinct runs can be set concurrently.
+         *
+         * @param i      the ordinal of the run
+         * @param result the statistics
+         */
+        inline void set(const size_type i, const WideResult& result);
+
+        /**
+         * @brief Get the column of the lengths of the cycles.
+         *
+         * @return the lengths of the cycles, sorted by ordinal
+         */
+        const column_t<vec_t::size_type>& cycleLens() const
+        {
+            return m_cycleLens;
+        }
+        /**
+         * @brief Get the column of the maximum terms.
+         *
+         * @return the maximum terms, sorted by ordinal
+         */
+        const column_t<int64_t>& maxTerms() const { return m_maxTerms; }
+    private:
+        vec_t m_uz;
+        int64_t m_step;
+        column_t<vec_t::size_type> m_cycleLens;
+        column_t<int64_t> m_maxTerms;
+        std::map<size_type, int128_t> m_wide;
+        mutable std::mutex m_mutex;
+    };
+
+    inline void ResultTable::reset(const vec_t& uz, const size_type n)
+    {
+        m_uz = uz;
+        m_cycleLens.resize(n);
+        m_maxTerms.resize(n);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wide.clear();
+    }
+
+    inline ResultTable::vec_t ResultTable::uz(const size_type i) const
+    {
+        vec_t ret = m_uz;
+        const auto shift = static_cast<int64_t>(i) * m_step;
+
+        for (auto& j : ret)
+            j += shift;
+
+        return ret;
+    }
+
+    inline int128_t ResultTable::wideMaxTerm(const size_type i) const
+    {
+        if (m_maxTerms[i] == std::numeric_limits<int64_t>::max()) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto it = m_wide.find(i);
+
+            if (it != m_wide.end())
+                return it->second;
+        }
+
+        return m_maxTerms[i];
+    }
+
+    inline bool ResultTable::isWide(const size_type i) const
+    {
+        if (m_maxTerms[i] != std::numeric_limits<int64_t>::max())
+            return false;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_wide.count(i) != 0;
+    }
+
+    inline void ResultTable::set(const size_type i, const WideResult& result)
+    {
+        m_cycleLens[i] = result.cycleLen;
+
+        if (result.maxTerm < std::numeric_limits<int64_t>::max()) {
+            m_maxTerms[i] = static_cast<int64_t>(result.maxTerm);
+        } else {
+            m_maxTerms[i] = std::numeric_limits<int64_t>::max();
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_wide[i] = result.maxTerm;
+        }
+    }
+}
+
+#endif // SYRACUSE_RESULT_TABLE_HPP
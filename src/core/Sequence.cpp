@@ -18,70 +18,225 @@
 
 #include "core/Sequence.hpp"
 
-#include <future>
-#include <iostream>
+#include "core/Metrics.hpp"
+#include "core/Recording.hpp"
+#include "core/ResultCache.hpp"
+#include "core/ResultTable.hpp"
+#include "core/ThreadPool.hpp"
+
+#include <algorithm>
+#include <stdexcept>
 
 namespace sequence
 {
-    int64_t Sequence::at(const vec_t::size_type n, const vec_t& uz) const
+    namespace
+    {
+        // Run from `uz` until `value`, giving each term to `record`. The
+        // cache is only looked up by the runs that record nothing.
+        template<typename Record>
+        Sequence::Result until(const Sequence& seq,
+                               const Sequence::vec_t& uz, const int64_t value,
+                               ResultCache* cache, Record& record)
+        {
+            auto c = seq.cursor(uz);
+            int64_t maxTerm = *c;
+
+            for (; *c != value; ++c) {
+                Sequence::Result known;
+
+                if ((cache != nullptr) && cache->find(*c, known)) {
+                    return { c.rank() + known.cycleLen,
+                             std::max(maxTerm, known.maxTerm) };
+                }
+
+                record.push(*c);
+
+                if (*c > maxTerm)
+                    maxTerm = *c;
+            }
+
+            record.push(*c);
+
+            if (cache != nullptr)
+                cache->insert(uz.front(), { c.rank(), maxTerm });
+
+            return { c.rank(), maxTerm };
+        }
+    }
+
+    Sequence::Cursor::Cursor(const vec_t& uz, const seq_t& seq)
+        : m_window()
+        , m_seq(&seq)
+        , m_rank(0)
+        , m_offset(uz.size() - 1)
+    {
+        if (uz.empty()) {
+            throw std::invalid_argument("Sequence::Cursor::Cursor(): A "
+                                        "cursor cannot be created without "
+                                        "initial terms.");
+        }
+
+        if (auto* const pool = Pool<vec_t>::local())
+            m_window = pool->take();
+
+        m_window.assign(uz.rbegin(), uz.rend());
+    }
+
+    Sequence::Cursor::~Cursor()
+    {
+        if (m_window.capacity() == 0)
+            return;
+
+        if (auto* const pool = Pool<vec_t>::local())
+            pool->give(std::move(m_window));
+    }
+
+    Sequence::Cursor& Sequence::Cursor::advance(const vec_t::size_type n)
     {
-        int64_t ret;
-        const auto uzSize = uz.size();
+        for (vec_t::size_type i = 0; i < n; ++i)
+            next();
+
+        return *this;
+    }
+
+    void Sequence::Cursor::next()
+    {
+        if (m_offset > 0) {
+            --m_offset;
+        } else {
+            const int64_t term = (*m_seq)(m_window);
 
-        if (uzSize == 0) {
+            std::copy_backward(m_window.begin(), m_window.end() - 1,
+                               m_window.end());
+            m_window.front() = term;
+        }
+
+        ++m_rank;
+    }
+
+    Sequence::~Sequence()
+    {
+        m_uz.clear();
+        m_seq = nullptr;
+    }
+
+    int64_t Sequence::at(const vec_t::size_type n, const vec_t& uz) const
+    {
+        if (uz.empty()) {
             throw std::invalid_argument("Sequence::at(): When you create a "
                                         "`Sequence` object without initial "
                                         "terms, you must specify them to "
                                         "call this method.");
         }
 
-        if (n < uzSize) {
-            ret = uz.at(n);
-        } else {
-            vec_t vec;
-            for (vec_t::size_type i = 1; i <= uzSize; ++i)
-                vec.push_back(at(n - i, uz));
+        return *cursor(uz).advance(n);
+    }
 
-            ret = m_seq(vec);
-        }
+    Sequence::Result Sequence::doUntil(const int64_t value,
+                                       const vec_t& uz) const
+    {
+        ResultCache* cache = nullptr;
+        if (m_cache && (m_cache->value() == value) && (uz.size() == 1))
+            cache = m_cache.get();
 
-        return ret;
+        recording::None record;
+        return until(*this, uz, value, cache, record);
     }
 
-    Ref<Sequence::Result> Sequence::doUntil(const int64_t value,
-                                            const vec_t uz) const
+    Sequence::Result Sequence::doUntil(const int64_t value, const vec_t& uz,
+                                       vec_t& terms) const
     {
-        vec_t::size_type cycle = 0;
-        int64_t maxTerm = at(0);
+        terms.clear();
 
-        for (auto term = maxTerm; term != value; term = at(++cycle, uz)) {
-            if (term > maxTerm)
-                maxTerm = term;
+        recording::Terms record{ terms };
+        return until(*this, uz, value, nullptr, record);
+    }
+
+    CycleResult Sequence::doUntilCycle(const uint64_t budget,
+                                       const vec_t& uz) const
+    {
+        auto hare = cursor(uz);
+        int64_t maxTerm = *std::max_element(uz.begin(), uz.end());
+
+        // The window is only a state of the run once it is made of
+        // computed terms.
+        hare.advance(uz.size() - 1);
+
+        const Cursor start = hare;
+        Cursor tortoise = hare;
+        vec_t::size_type power = 1;
+        vec_t::size_type cycleLen = 0;
+
+        // The current terms are compared first, which mostly differ.
+        const auto same = [](const Cursor& a, const Cursor& b) {
+            return (*a == *b) && (a.window() == b.window());
+        };
+
+        // The hare meets all the terms before the end of the cycle.
+        for (uint64_t steps = 0;; ++steps) {
+            if (steps == budget)
+                return { false, 0, 0, maxTerm };
+
+            ++hare;
+            ++cycleLen;
+            maxTerm = std::max(maxTerm, *hare);
+
+            if (same(hare, tortoise))
+                break;
+
+            if (cycleLen == power) {
+                tortoise = hare;
+                power *= 2;
+                cycleLen = 0;
+            }
+        }
+
+        // Two cursors one cycle apart meet at its first term.
+        tortoise = start;
+        hare = start;
+        hare.advance(cycleLen);
+
+        vec_t::size_type preperiod = 0;
+
+        for (; !same(hare, tortoise); ++preperiod) {
+            ++tortoise;
+            ++hare;
         }
 
-        return std::make_shared<Aggregater<Result>>(cycle, maxTerm);
+        return { true, preperiod, cycleLen, maxTerm };
     }
 
-    Ref<Sequence::ResultMap> Sequence::loadNUntil(const uint8_t n,
-                                                  const int64_t value,
-                                                  const uint8_t step) const
+    Sequence::WideResult Sequence::doUntilWide(const int64_t value,
+                                               const vec_t& uz) const
     {
-        vec_t uz = m_uz;
+        const auto ret = doUntil(value, uz);
+        return { ret.cycleLen, ret.maxTerm };
+    }
 
-        using doUntil_t = Ref<Result> (Sequence::*)(int64_t,
-                                                    const vec_t) const;
-        std::map<vec_t, std::future<Ref<Result>>> map;
-        for (uint8_t i = 0; i < n; ++i) {
-            map[uz] = std::async(static_cast<doUntil_t>(&Sequence::doUntil),
-                                 this, value, uz);
+    Ref<ResultTable> Sequence::loadNUntil(const uint64_t n,
+                                          const int64_t value,
+                                          const int64_t step) const
+    {
+        auto ret = std::make_shared<ResultTable>(m_uz, step, n);
 
-            std::for_each(uz.begin(), uz.end(),
-                          [=](int64_t& i) { i += step; });
-        }
+        ThreadPool::global().parallelFor(0, n, 0,
+            [&](const uint64_t begin, const uint64_t end) {
+                const Metrics::Chunk chunk(end - begin);
+                vec_t uz = ret->uz(begin);
+                uint64_t steps = 0;
+
+                for (uint64_t i = begin; i < end; ++i) {
+                    const auto result = doUntilWide(value, uz);
+
+                    ret->set(i, result);
+                    steps += result.cycleLen;
+
+                    for (auto& j : uz)
+                        j += step;
+                }
 
-        auto ret = std::make_shared<ResultMap>();
-        for (auto& [key, i] : map)
-            (*ret)[key] = i.get();
+                Metrics::add(Metrics::Steps, steps);
+            });
 
         return ret;
     }
@@ -22,7 +22,7 @@
 #include "core/core.hpp"
 
 #include <functional>
-#include <map>
+#include <vector>
 
 using namespace core;
 
@@ -31,6 +31,63 @@ using namespace core;
  */
 namespace sequence
 {
+    class ResultCache;
+    class ResultTable;
+
+    /**
+     * @struct BasicResult core/Sequence.hpp
+     * @brief Structure used for containing the result of the `doUntil()`
+     * methods.
+     *
+     * @tparam Int the type of the terms
+     */
+    template<typename Int>
+    struct BasicResult
+    {
+        /**
+         * @var std::size_t cycleLen
+         * The computed length of the cycle.
+         */
+        std::size_t cycleLen;
+        /**
+         * @var Int maxTerm
+         * The maximum term found during the process.
+         */
+        Int maxTerm;
+    };
+
+    /**
+     * @struct CycleResult core/Sequence.hpp
+     * @brief Structure used for containing the result of the
+     * `doUntilCycle()` methods.
+     *
+     * A run that does not find its cycle within the step budget, e.g.
+     * because it diverges, only reports the maximum term it met.
+     */
+    struct CycleResult
+    {
+        /**
+         * @var bool found
+         * Whether the cycle has been found within the step budget.
+         */
+        bool found;
+        /**
+         * @var std::size_t preperiod
+         * The number of terms before the first one of the cycle.
+         */
+        std::size_t preperiod;
+        /**
+         * @var std::size_t cycleLen
+         * The number of terms of the cycle.
+         */
+        std::size_t cycleLen;
+        /**
+         * @var int64_t maxTerm
+         * The maximum term found during the process.
+         */
+        int64_t maxTerm;
+    };
+
     /**
      * @class Sequence core/Sequence.hpp core/Sequence.hpp
      * @brief A class to help create a sequence.
@@ -63,36 +120,115 @@ namespace sequence
          *     return un_[1] + un_[0];
          * };
          * ```
+         *
+         * A linear relation such as this one can also be given by its
+         * coefficients to a \p LinearSequence, whose terms are reached in
+         * a logarithmic time.
          */
         using seq_t = std::function<int64_t(const vec_t&)>;
 
         /**
-         * @struct Result core/Sequence.hpp
-         * @brief Structure used for containing the result of the `doUntil()`
-         * methods.
+         * @brief Type containing the result of the `doUntil()` methods.
          *
-         * @see doUntil(const int64_t value, const vec_t uz) const
+         * @see doUntil(const int64_t value, const vec_t& uz) const
          * @see doUntil(const int64_t value) const
          */
-        struct Result
+        using Result = BasicResult<int64_t>;
+        /**
+         * @brief Type containing the result of the `doUntilWide()` method.
+         *
+         * @see doUntilWide(const int64_t value, const vec_t& uz) const
+         */
+        using WideResult = BasicResult<int128_t>;
+
+        /**
+         * @class Cursor core/Sequence.hpp
+         * @brief A cursor stepping through the terms of a sequence.
+         *
+         * A cursor only keeps the last terms needed by the recurrence
+         * relation in a fixed-size window, so that moving from one rank to
+         * the next one costs a single evaluation of the relation and no
+         * allocation. The windows are recycled through the `core::Pool` of
+         * each thread, so that creating a cursor does not allocate either
+         * once the pool is warm.
+         *
+         * @par Example
+         *
+         * ```cpp
+         * auto c = mySeq.cursor({0, 1});
+         * for (; c.rank() < 10; ++c)
+         *     std::cout << *c << std::endl;
+         * ```
+         *
+         * @warning
+         * A cursor refers to the recurrence relation of the \p Sequence
+         * object that created it: it must not outlive this object.
+         */
+        class Cursor
         {
+        public:
             /**
-             * @var vec_t::size_type cycleLen
-             * The computed length of the cycle.
+             * @brief Construct a cursor pointing to the first term.
+             *
+             * @mustinit{uz}
+             *
+             * @param uz  the initial terms
+             * @param seq the recurrence relation
              */
-            vec_t::size_type cycleLen;
+            Cursor(const vec_t& uz, const seq_t& seq);
+            Cursor(const Cursor&) = default;
+            Cursor(Cursor&&) = default;
+            Cursor& operator=(const Cursor&) = default;
+            Cursor& operator=(Cursor&&) = default;
             /**
-             * @var int64_t maxTerm
-             * The maximum term found during the process.
+             * @brief Give the window back to the `core::Pool` of the
+             * thread.
              */
-            int64_t maxTerm;
-        };
+            ~Cursor();
 
-        /**
-         * @brief A map storing where each \p Result pointer is associated
-         * with the given initial terms.
-         */
-        using ResultMap = std::map<vec_t, Ref<Result>>;
+            /**
+             * @brief Get the term of the current rank.
+             *
+             * @return the current term
+             */
+            inline int64_t operator*() const;
+            /**
+             * @brief Move to the next rank.
+             *
+             * @return a reference to the current object
+             */
+            inline Cursor& operator++();
+            /**
+             * @brief Move \p n ranks forward.
+             *
+             * @param n the number of ranks to skip
+             * @return  a reference to the current object
+             */
+            Cursor& advance(const vec_t::size_type n);
+
+            /**
+             * @brief Get the current rank.
+             *
+             * @return the current rank
+             */
+            inline vec_t::size_type rank() const;
+            /**
+             * @brief Get the window of the last terms.
+             *
+             * The terms are sorted in the order expected by the recurrence
+             * relation, i.e. the most recent one comes first.
+             *
+             * @return the window of the last terms
+             */
+            inline const vec_t& window() const;
+        private:
+            void next();
+        private:
+            vec_t m_window;
+            const seq_t* m_seq;
+            vec_t::size_type m_rank;
+            vec_t::size_type m_offset;
+        };
     public:
         /**
          * @brief Construct an object from a recurrence relation and set the
@@ -125,7 +261,7 @@ namespace sequence
          */
         Sequence(const seq_t& seq)
             : Sequence({}, seq) {}
-        inline virtual ~Sequence();
+        virtual ~Sequence();
         /**
          * @brief Set the initial terms to the current object.
          *
@@ -144,12 +280,64 @@ namespace sequence
          * @return   a reference to the modified object
          */
         inline Sequence& withUz(const vec_t& uz);
+        /**
+         * @brief Get the initial terms of the current object.
+         *
+         * @return the initial terms
+         */
+        const vec_t& uz() const { return m_uz; }
+        /**
+         * @brief Set the cache shared by the runs of `doUntil()`.
+         *
+         * The cache is only used by the runs whose target value is the one
+         * of the cache, and whose recurrence relation is of order 1.
+         *
+         * @note
+         * This method does not create another object: it returns a reference
+         * to the current modified object.
+         *
+         * @param cache the cache, or `nullptr` not to use any
+         * @return      a reference to the modified object
+         */
+        inline Sequence& withCache(const Ref<ResultCache>& cache);
+        /**
+         * @brief Get the cache shared by the runs of `doUntil()`.
+         *
+         * @return the cache, or `nullptr` if there is none
+         */
+        const Ref<ResultCache>& cache() const { return m_cache; }
+
+        /**
+         * @brief Get a cursor pointing to the first term with the given
+         * initial terms.
+         *
+         * @mustinit{uz}
+         *
+         * @param uz the initial terms
+         * @return   a cursor pointing to \f$u_0\f$
+         */
+        inline Cursor cursor(const vec_t& uz) const;
+        /**
+         * @brief Get a cursor pointing to the first term.
+         *
+         * @mustinit{m_uz}
+         *
+         * @return a cursor pointing to \f$u_0\f$
+         *
+         * @see cursor(const vec_t& uz) const
+         */
+        inline Cursor cursor() const;
 
         /**
          * @brief Get the term of the corresponding rank with the given
          * initial terms.
          *
-         * This method is the equivalent of \f$u_n\f$.
+         * This method is the equivalent of \f$u_n\f$. The terms are
+         * evaluated one by one through a \p Cursor.
+         *
+         * @note
+         * Subclasses can override this method to reach the rank faster,
+         * as \p LinearSequence does.
          *
          * @mustinit{uz}
          *
@@ -157,7 +345,7 @@ namespace sequence
          * @param uz the initial terms
          * @return   the nth term
          */
-        int64_t at(const vec_t::size_type n, const vec_t& uz) const;
+        virtual int64_t at(const vec_t::size_type n, const vec_t& uz) const;
         /**
          * @brief Get the term of the corresponding rank.
          *
@@ -173,13 +361,24 @@ namespace sequence
          * @brief Run the sequence until some value with the given initial
          * terms.
          *
+         * The terms are generated in a single pass through a \p Cursor, so
+         * this method runs in a time linear in the length of the cycle.
+         *
+         * If a cache has been set, the run stops as soon as it meets a
+         * term whose result is known, and its own result is cached.
+         *
+         * @note
+         * Subclasses can override this method to provide a faster engine
+         * dedicated to their recurrence relation. `loadNUntil()` uses it
+         * too.
+         *
          * @mustinit{uz}
          *
          * @param value run the sequence until
          * @param uz    the initial terms
          * @return      some statistics
          */
-        Ref<Result> doUntil(const int64_t value, const vec_t uz) const;
+        virtual Result doUntil(const int64_t value, const vec_t& uz) const;
         /**
          * @brief Run the sequence until some value.
          *
@@ -188,26 +387,132 @@ namespace sequence
          * @param value run the sequence until
          * @return      some statistics
          */
-        inline Ref<Result> doUntil(const int64_t value) const;
+        inline Result doUntil(const int64_t value) const;
+        /**
+         * @brief Run the sequence until some value with the given initial
+         * terms, recording all the terms met.
+         *
+         * The cache is not used, since it would skip the terms to record.
+         * The runs that do not record anything are not slowed down.
+         *
+         * @mustinit{uz}
+         *
+         * @param value run the sequence until
+         * @param uz    the initial terms
+         * @param terms the buffer receiving the terms from \f$u_0\f$ to
+         *              \p value, whose previous contents are replaced
+         * @return      some statistics
+         */
+        Result doUntil(const int64_t value, const vec_t& uz,
+                       vec_t& terms) const;
+        /**
+         * @brief Run the sequence until some value with the given initial
+         * terms, without any limit on the maximum term.
+         *
+         * The default implementation is the same as `doUntil()`, the terms
+         * of a \p seq_t being 64-bit integers. Subclasses whose terms may
+         * exceed them override it to go on with wider integers.
+         *
+         * @mustinit{uz}
+         *
+         * @param value run the sequence until
+         * @param uz    the initial terms
+         * @return      some statistics
+         */
+        virtual WideResult doUntilWide(const int64_t value,
+                                       const vec_t& uz) const;
+        /**
+         * @brief Run the sequence until it enters a cycle with the given
+         * initial terms.
+         *
+         * Unlike `doUntil()`, no target value is needed: the run stops as
+         * soon as the window of the last terms, which determines all the
+         * next ones, comes back to a previous state. The cycle is found by
+         * Brent's algorithm, which only keeps three windows whatever the
+         * length of the run.
+         *
+         * The budget counts the steps of the hare, which may need up to
+         * about twice as many steps as there are terms before the end of
+         * the cycle to detect it: the run below is not found to cycle with
+         * a budget of 10 steps. Once the cycle is detected, finding its
+         * first term takes about one more step per term before the end of
+         * the cycle, on top of the budget.
+         *
+         * @par Example
+         * The code below corresponds to the \f$3n - 1\f$ variant of the
+         * Syracuse sequence, which enters the cycle
+         * \f$5, 14, 7, 20, 10\f$:
+         *
+         * ```cpp
+         * sequence::Sequence mySeq([](const sequence::Sequence::vec_t& un_) {
+         *     return (un_[0] % 2 == 0) ? un_[0] / 2 : 3 * un_[0] - 1;
+         * });
+         *
+         * mySeq.doUntilCycle(1000, {10}); // returns {true, 0, 5, 20}
+         * ```
+         *
+         * @warning
+         * The relation must not overflow before the cycle is found or the
+         * budget is exhausted.
+         *
+         * @mustinit{uz}
+         *
+         * @param budget the number of steps of the hare after which the run
+         *               gives up
+         * @param uz     the initial terms
+         * @return       some statistics
+         */
+        CycleResult doUntilCycle(const uint64_t budget, const vec_t& uz) const;
+        /**
+         * @brief Run the sequence until it enters a cycle.
+         *
+         * @mustinit{m_uz}
+         *
+         * @param budget the number of steps of the hare after which the run
+         *               gives up
+         * @return       some statistics
+         *
+         * @see doUntilCycle(const uint64_t budget, const vec_t& uz) const
+         */
+        inline CycleResult doUntilCycle(const uint64_t budget) const;
         /**
          * @brief Run `doUntil()` several times asynchronously.
          *
+         * The runs are split into chunks shared by the threads of
+         * `ThreadPool::global()`.
+         *
          * @param n     run `doUntil()` \p n times
          * @param value run the sequence until
          * @param step  the step incrementing the initial terms
-         * @return      a pointer to a map where each \p Result is associated
-         *              with the initial terms
+         * @return      a pointer to a table where each \p Result is
+         *              associated with the initial terms
          */
-        Ref<ResultMap> loadNUntil(const uint8_t n, const int64_t value, const uint8_t step = 1) const;
+        Ref<ResultTable> loadNUntil(const uint64_t n, const int64_t value, const int64_t step = 1) const;
     private:
         vec_t m_uz;
         seq_t m_seq;
+        Ref<ResultCache> m_cache;
     };
 
-    inline Sequence::~Sequence()
+    inline int64_t Sequence::Cursor::operator*() const
+    {
+        return m_window[m_offset];
+    }
+
+    inline Sequence::Cursor& Sequence::Cursor::operator++()
+    {
+        next();
+        return *this;
+    }
+
+    inline Sequence::vec_t::size_type Sequence::Cursor::rank() const
+    {
+        return m_rank;
+    }
+
+    inline const Sequence::vec_t& Sequence::Cursor::window() const
     {
-        m_uz.clear();
-        m_seq = nullptr;
+        return m_window;
     }
 
     inline Sequence& Sequence::withUz(const vec_t& uz)
@@ -216,15 +521,36 @@ namespace sequence
         return *this;
     }
 
+    inline Sequence& Sequence::withCache(const Ref<ResultCache>& cache)
+    {
+        m_cache = cache;
+        return *this;
+    }
+
+    inline Sequence::Cursor Sequence::cursor(const vec_t& uz) const
+    {
+        return Cursor(uz, m_seq);
+    }
+
+    inline Sequence::Cursor Sequence::cursor() const
+    {
+        return cursor(m_uz);
+    }
+
     inline int64_t Sequence::at(vec_t::size_type n) const
     {
         return at(n, m_uz);
     }
 
-    inline Ref<Sequence::Result> Sequence::doUntil(const int64_t value) const
+    inline Sequence::Result Sequence::doUntil(const int64_t value) const
     {
         return doUntil(value, m_uz);
     }
+
+    inline CycleResult Sequence::doUntilCycle(const uint64_t budget) const
+    {
+        return doUntilCycle(budget, m_uz);
+    }
 }
 
 #endif // SYRACUSE_SEQUENCE_HPP
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/Simd.hpp"
+
+#include "core/ResultTable.hpp"
+
+#include <limits>
+
+namespace sequence
+{
+    namespace simd
+    {
+        namespace
+        {
+            typedef int64_t lanes_t
+                __attribute__((vector_size(lanes * sizeof(int64_t))));
+
+            // The status of a lane.
+            constexpr int64_t Running = 0;
+            constexpr int64_t Done = 1;
+            constexpr int64_t Overflow = 2;
+
+            struct State
+            {
+                lanes_t n;
+                lanes_t maxTerm;
+                lanes_t cycleLen;
+                lanes_t status;
+            };
+
+            // The lanes whose term is zero are idle: zero is its own next
+            // term and never reaches a strictly positive value.
+            __attribute__((target_clones("avx512f", "avx2", "default")))
+            void advance(State* s, const int64_t value,
+                         const unsigned int iterations)
+            {
+                constexpr int64_t limit =
+                    (std::numeric_limits<int64_t>::max() - 1) / 3;
+
+                lanes_t n = s->n;
+                lanes_t maxTerm = s->maxTerm;
+                lanes_t cycleLen = s->cycleLen;
+                lanes_t status = s->status;
+
+                for (unsigned int i = 0; i < iterations; ++i) {
+                    const lanes_t odd = n & 1;
+                    const lanes_t oddMask = -odd;
+
+                    // 3n + 1 for the odd lanes, n for the even ones.
+                    const lanes_t t = n + ((2 * n + 1) & oddMask);
+                    const lanes_t overflow = oddMask & (n > limit);
+                    const lanes_t hit = oddMask & (t == value);
+                    const lanes_t active = (n != 0);
+
+                    maxTerm = ((t > maxTerm) & ~hit) ? t : maxTerm;
+                    cycleLen += (1 + (odd & ~hit)) & active;
+
+                    const lanes_t next = t >> 1;
+                    const lanes_t done = hit | (next == value);
+
+                    status |= (done & Done) | (overflow & Overflow);
+                    n = (done | overflow) ? 0 : next;
+                }
+
+                s->n = n;
+                s->maxTerm = maxTerm;
+                s->cycleLen = cycleLen;
+                s->status = status;
+            }
+        }
+
+        const char* isa()
+        {
+            if (__builtin_cpu_supports("avx512f"))
+                return "avx512f";
+            else if (__builtin_cpu_supports("avx2"))
+                return "avx2";
+            else
+                return "default";
+        }
+
+        void runUntil(ResultTable& table, const std::size_t begin,
+                      const std::size_t end, const int64_t value,
+                      const CollatzSequence& fallback)
+        {
+            State s = {};
+            std::size_t ordinals[lanes];
+            std::size_t next = begin;
+            unsigned int running = 0;
+
+            const int64_t first = table.uz().front();
+            const int64_t step = table.step();
+
+            const auto refill = [&](const unsigned int lane) {
+                s.n[lane] = 0;
+                s.status[lane] = Running;
+
+                for (; next < end; ++next) {
+                    const int64_t uz =
+                        first + static_cast<int64_t>(next) * step;
+
+                    if (uz == value) {
+                        table.set(next, Sequence::Result{ 0, uz });
+                    } else {
+                        s.n[lane] = uz;
+                        s.maxTerm[lane] = uz;
+                        s.cycleLen[lane] = 0;
+                        ordinals[lane] = next++;
+                        ++running;
+                        break;
+                    }
+                }
+            };
+
+            for (unsigned int i = 0; i < lanes; ++i)
+                refill(i);
+
+            while (running > 0) {
+                // The lanes are checked every few steps only, a finished
+                // lane staying idle meanwhile.
+                advance(&s, value, 16);
+
+                for (unsigned int i = 0; i < lanes; ++i) {
+                    if (s.status[i] == Running)
+                        continue;
+
+                    const std::size_t ordinal = ordinals[i];
+
+                    if (s.status[i] == Done) {
+                        table.set(ordinal, Sequence::Result{
+                            static_cast<std::size_t>(s.cycleLen[i]),
+                            s.maxTerm[i] });
+                    } else {
+                        table.set(ordinal, fallback.doUntilWide(
+                            value, table.uz(ordinal)));
+                    }
+
+                    --running;
+                    refill(i);
+                }
+            }
+        }
+    }
+}
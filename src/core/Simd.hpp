@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_SIMD_HPP
+#define SYRACUSE_SIMD_HPP
+
+#include "core/CollatzSequence.hpp"
+
+namespace sequence
+{
+    class ResultTable;
+
+    /**
+     * @brief Namespace providing the evaluation of several runs of the
+     * Syracuse sequence in lockstep.
+     *
+     * The runs are spread over the lanes of vector registers, whose width
+     * is chosen at run time: the widest instruction set supported by the
+     * CPU among AVX-512, AVX2 and the baseline one is used.
+     */
+    namespace simd
+    {
+        /**
+         * @brief The number of runs evaluated in lockstep.
+         *
+         * Eight 64-bit lanes fill one AVX-512 register. Wider vectors do
+         * not pay off since the state of the lanes no longer fits in the
+         * registers.
+         */
+        constexpr unsigned int lanes = 8;
+
+        /**
+         * @brief Get the name of the instruction set used.
+         *
+         * @return `"avx512f"`, `"avx2"` or `"default"`
+         */
+        const char* isa();
+
+        /**
+         * @brief Run the Syracuse sequence until some value for a range of
+         * the runs of a table.
+         *
+         * Each lane runs the shortcut form, its parity being selected
+         * through a mask. As soon as a lane reaches \p value, its result is
+         * written to \p table and it is refilled with the next run.
+         *
+         * @warning
+         * The initial terms and \p value must be strictly positive. The
+         * runs whose terms exceed 64 bits are run again by \p fallback.
+         *
+         * @param table    the table holding the initial terms and
+         *                 receiving the results
+         * @param begin    the ordinal of the first run
+         * @param end      the ordinal following the last run
+         * @param value    run the sequence until
+         * @param fallback the sequence running the runs that overflow
+         */
+        void runUntil(ResultTable& table, const std::size_t begin,
+                      const std::size_t end, const int64_t value,
+                      const CollatzSequence& fallback);
+    }
+}
+
+#endif // SYRACUSE_SIMD_HPP
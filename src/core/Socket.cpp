@@ -0,0 +1,263 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/Socket.hpp"
+
+#include "core/Varint.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace core
+{
+    namespace
+    {
+        std::runtime_error error(const char* where, const int err = errno)
+        {
+            return std::runtime_error(std::string(where) + ": "
+                                      + std::strerror(err));
+        }
+    }
+
+    Socket& Socket::operator=(Socket&& other) noexcept
+    {
+        if (this != &other) {
+            close();
+            m_fd = other.m_fd;
+            other.m_fd = -1;
+        }
+
+        return *this;
+    }
+
+    Socket::~Socket()
+    {
+        close();
+    }
+
+    Socket Socket::connect(const std::string& host, const uint16_t port)
+    {
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        addrinfo* addrs = nullptr;
+        const int ret = ::getaddrinfo(host.c_str(),
+                                      std::to_string(port).c_str(), &hints,
+                                      &addrs);
+
+        if (ret != 0) {
+            throw std::runtime_error("Socket::connect(): " + host + ": "
+                                     + ::gai_strerror(ret));
+        }
+
+        int err = 0;
+
+        for (const addrinfo* i = addrs; i != nullptr; i = i->ai_next) {
+            Socket s(::socket(i->ai_family, i->ai_socktype | SOCK_CLOEXEC,
+                              i->ai_protocol));
+
+            if (s.isValid() && (::connect(s.m_fd, i->ai_addr, i->ai_addrlen) == 0)) {
+                ::freeaddrinfo(addrs);
+
+                // The messages are small and answered at once.
+                const int one = 1;
+                ::setsockopt(s.m_fd, IPPROTO_TCP, TCP_NODELAY, &one,
+                             sizeof(one));
+
+                return s;
+            }
+
+            err = errno;
+        }
+
+        ::freeaddrinfo(addrs);
+        throw error("Socket::connect()", err);
+    }
+
+    Socket Socket::listen(const uint16_t port)
+    {
+        Socket s(::socket(AF_INET6, SOCK_STREAM | SOCK_CLOEXEC, 0));
+
+        if (!s.isValid())
+            throw error("Socket::listen()");
+
+        const int one = 1;
+        const int zero = 0;
+        ::setsockopt(s.m_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        ::setsockopt(s.m_fd, IPPROTO_IPV6, IPV6_V6ONLY, &zero, sizeof(zero));
+
+        sockaddr_in6 addr = {};
+        addr.sin6_family = AF_INET6;
+        addr.sin6_addr = in6addr_any;
+        addr.sin6_port = htons(port);
+
+        if ((::bind(s.m_fd, reinterpret_cast<const sockaddr*>(&addr),
+                    sizeof(addr)) != 0)
+            || (::listen(s.m_fd, SOMAXCONN) != 0)) {
+            throw error("Socket::listen()");
+        }
+
+        return s;
+    }
+
+    uint16_t Socket::port() const
+    {
+        sockaddr_in6 addr = {};
+        socklen_t len = sizeof(addr);
+
+        if (::getsockname(m_fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0)
+            throw error("Socket::port()");
+
+        return ntohs(addr.sin6_port);
+    }
+
+    std::string Socket::peer() const
+    {
+        sockaddr_storage addr = {};
+        socklen_t len = sizeof(addr);
+        char host[NI_MAXHOST], serv[NI_MAXSERV];
+
+        if ((::getpeername(m_fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0)
+            || (::getnameinfo(reinterpret_cast<const sockaddr*>(&addr), len,
+                              host, sizeof(host), serv, sizeof(serv),
+                              NI_NUMERICHOST | NI_NUMERICSERV) != 0)) {
+            return std::string();
+        }
+
+        return std::string(host) + ':' + serv;
+    }
+
+    Socket Socket::accept(const std::chrono::milliseconds timeout)
+    {
+        pollfd pfd = { m_fd, POLLIN, 0 };
+        const int ret = ::poll(&pfd, 1, static_cast<int>(timeout.count()));
+
+        if (ret < 0) {
+            if (errno == EINTR)
+                return Socket();
+
+            throw error("Socket::accept()");
+        } else if (ret == 0) {
+            return Socket();
+        }
+
+        Socket s(::accept4(m_fd, nullptr, nullptr, SOCK_CLOEXEC));
+
+        if (!s.isValid())
+            throw error("Socket::accept()");
+
+        const int one = 1;
+        ::setsockopt(s.m_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        return s;
+    }
+
+    void Socket::send(const Message& message)
+    {
+        std::vector<unsigned char> header;
+        varint::putFixed(header, message.type);
+        varint::putFixed(header, static_cast<uint64_t>(message.payload.size()));
+
+        sendAll(header.data(), header.size());
+        sendAll(message.payload.data(), message.payload.size());
+    }
+
+    Socket::Message Socket::receive(const uint64_t maxSize)
+    {
+        unsigned char header[12];
+        receiveAll(header, sizeof(header));
+
+        Message ret;
+        ret.type = varint::getFixed<uint32_t>(header);
+        const auto size = varint::getFixed<uint64_t>(header + 4);
+
+        if (size > maxSize) {
+            throw std::runtime_error("Socket::receive(): The message is too "
+                                     "large.");
+        }
+
+        ret.payload.resize(static_cast<std::size_t>(size));
+        receiveAll(ret.payload.data(), ret.payload.size());
+
+        return ret;
+    }
+
+    void Socket::shutdown()
+    {
+        if (m_fd >= 0)
+            ::shutdown(m_fd, SHUT_RD);
+    }
+
+    void Socket::close()
+    {
+        if (m_fd >= 0) {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+    }
+
+    void Socket::sendAll(const void* data, std::size_t size)
+    {
+        auto p = static_cast<const char*>(data);
+
+        while (size > 0) {
+            const ssize_t n = ::send(m_fd, p, size, MSG_NOSIGNAL);
+
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+
+                throw error("Socket::send()");
+            }
+
+            p += n;
+            size -= static_cast<std::size_t>(n);
+        }
+    }
+
+    void Socket::receiveAll(void* data, std::size_t size)
+    {
+        auto p = static_cast<char*>(data);
+
+        while (size > 0) {
+            const ssize_t n = ::recv(m_fd, p, size, 0);
+
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+
+                throw error("Socket::receive()");
+            } else if (n == 0) {
+                throw std::runtime_error("Socket::receive(): The connection "
+                                         "was closed.");
+            }
+
+            p += n;
+            size -= static_cast<std::size_t>(n);
+        }
+    }
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_SOCKET_HPP
+#define SYRACUSE_SOCKET_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace core
+{
+    /**
+     * @class Socket core/Socket.hpp core/Socket.hpp
+     * @brief A TCP socket exchanging framed messages.
+     *
+     * Each message is sent as its type and the size of its payload, as a
+     * little-endian `uint32_t` and `uint64_t`, followed by the payload.
+     * All the errors are reported by throwing an `std::runtime_error`,
+     * including the closing of the connection by the peer.
+     */
+    class Socket
+    {
+    public:
+        /**
+         * @brief Type representing a message.
+         */
+        struct Message
+        {
+            /**
+             * @var uint32_t type
+             * @brief The type, whose meaning is left to the protocol.
+             */
+            uint32_t type;
+            /**
+             * @var std::vector<unsigned char> payload
+             * @brief The content.
+             */
+            std::vector<unsigned char> payload;
+        };
+    public:
+        /**
+         * @brief Construct an invalid socket.
+         */
+        Socket() : m_fd(-1) {}
+        Socket(const Socket&) = delete;
+        Socket& operator=(const Socket&) = delete;
+        Socket(Socket&& other) noexcept : m_fd(other.m_fd) { other.m_fd = -1; }
+        Socket& operator=(Socket&& other) noexcept;
+        /**
+         * @brief Close the socket.
+         */
+        ~Socket();
+
+        /**
+         * @brief Connect to a listening socket.
+         *
+         * @param host the name or the address of the host
+         * @param port the port
+         * @return     the connected socket
+         */
+        static Socket connect(const std::string& host, const uint16_t port);
+        /**
+         * @brief Listen on all the interfaces.
+         *
+         * @param port the port, or 0 to choose any free one
+         * @return     the listening socket
+         */
+        static Socket listen(const uint16_t port);
+
+        /**
+         * @brief Check whether the socket is valid.
+         *
+         * @return `true` if the socket is open
+         */
+        bool isValid() const { return m_fd >= 0; }
+        /**
+         * @brief Get the local port of the socket.
+         *
+         * @return the port
+         */
+        uint16_t port() const;
+        /**
+         * @brief Get the address of the peer.
+         *
+         * @return the numeric host and port of the peer, or an empty string
+         *         if the socket is not connected
+         */
+        std::string peer() const;
+
+        /**
+         * @brief Wait for a connection and accept it.
+         *
+         * @param timeout the maximum time to wait
+         * @return        the connected socket, or an invalid one if the
+         *                time ran out
+         */
+        Socket accept(const std::chrono::milliseconds timeout);
+        /**
+         * @brief Send a message.
+         *
+         * @param message the message
+         */
+        void send(const Message& message);
+        /**
+         * @brief Wait for a message and receive it.
+         *
+         * @param maxSize the maximum size of the payload accepted
+         * @return        the message
+         */
+        Message receive(const uint64_t maxSize = uint64_t(1) << 32);
+        /**
+         * @brief Stop the receiving, waking a thread waiting for a message.
+         *
+         * Unlike `close()`, this method can be called while another thread
+         * uses the socket.
+         */
+        void shutdown();
+        /**
+         * @brief Close the socket.
+         */
+        void close();
+    private:
+        explicit Socket(const int fd) : m_fd(fd) {}
+
+        void sendAll(const void* data, std::size_t size);
+        void receiveAll(void* data, std::size_t size);
+    private:
+        int m_fd;
+    };
+}
+
+#endif // SYRACUSE_SOCKET_HPP
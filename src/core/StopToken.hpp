@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_STOP_TOKEN_HPP
+#define SYRACUSE_STOP_TOKEN_HPP
+
+#include "core/core.hpp"
+
+#include <atomic>
+
+namespace core
+{
+    /**
+     * @class StopToken core/StopToken.hpp core/StopToken.hpp
+     * @brief A view of a \p StopSource telling whether a stop has been
+     * requested.
+     *
+     * Tokens are cheap to copy, and checking one costs a relaxed load: the
+     * long tasks check it between their chunks to stop cooperatively.
+     *
+     * @par Example
+     *
+     * ```cpp
+     * core::StopSource source;
+     * sweep.withStopToken(source.token());
+     * // from another thread
+     * source.requestStop();
+     * ```
+     */
+    class StopToken
+    {
+    public:
+        /**
+         * @brief Construct a token that is never stopped.
+         */
+        StopToken()
+            : m_state() {}
+
+        /**
+         * @brief Check whether a stop has been requested.
+         *
+         * @return `true` if `StopSource::requestStop()` has been called
+         */
+        bool stopRequested() const
+        {
+            return m_state && m_state->load(std::memory_order_relaxed);
+        }
+        /**
+         * @brief Check whether a stop can be requested.
+         *
+         * @return `false` if the token was constructed by default
+         */
+        bool stopPossible() const { return static_cast<bool>(m_state); }
+    private:
+        friend class StopSource;
+
+        explicit StopToken(const Ref<const std::atomic<bool>>& state)
+            : m_state(state) {}
+    private:
+        Ref<const std::atomic<bool>> m_state;
+    };
+
+    /**
+     * @class StopSource core/StopToken.hpp core/StopToken.hpp
+     * @brief The owner of a stop request shared by several \p StopToken.
+     *
+     * The copies of a source share the same request.
+     */
+    class StopSource
+    {
+    public:
+        /**
+         * @brief Construct a source whose stop has not been requested.
+         */
+        StopSource()
+            : m_state(std::make_shared<std::atomic<bool>>(false)) {}
+
+        /**
+         * @brief Request the stop of the tokens of the source.
+         *
+         * @return `true` if the stop had not been requested yet
+         */
+        bool requestStop()
+        {
+            return !m_state->exchange(true, std::memory_order_relaxed);
+        }
+        /**
+         * @brief Check whether a stop has been requested.
+         *
+         * @return `true` if `requestStop()` has been called
+         */
+        bool stopRequested() const
+        {
+            return m_state->load(std::memory_order_relaxed);
+        }
+        /**
+         * @brief Get a token of the source.
+         *
+         * @return the token
+         */
+        StopToken token() const { return StopToken(m_state); }
+    private:
+        Ref<std::atomic<bool>> m_state;
+    };
+}
+
+#endif // SYRACUSE_STOP_TOKEN_HPP
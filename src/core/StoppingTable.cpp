@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/StoppingTable.hpp"
+
+#include "core/CollatzSequence.hpp"
+#include "core/ReplaceFile.hpp"
+#include "core/ThreadPool.hpp"
+
+#include <stdexcept>
+
+namespace sequence
+{
+    namespace
+    {
+        std::size_t length(const unsigned int bits)
+        {
+            return (std::size_t(1) << bits) * StoppingTable::entrySize;
+        }
+
+        void put(unsigned char* const p, const uint64_t n,
+                 const unsigned int size)
+        {
+            for (unsigned int i = 0; i < size; ++i)
+                p[i] = static_cast<unsigned char>(n >> (8 * i));
+        }
+    }
+
+    StoppingTable::StoppingTable(const unsigned int bits)
+        : m_bits(bits)
+        , m_limit(0)
+        , m_owned()
+        , m_file()
+        , m_data(nullptr)
+    {
+        if ((bits == 0) || (bits > maxBits)) {
+            throw std::invalid_argument("StoppingTable::StoppingTable(): The "
+                                        "number of bits must be between 1 "
+                                        "and 32.");
+        }
+
+        m_limit = int64_t(1) << bits;
+        m_owned.assign(length(bits), 0);
+        m_data = m_owned.data();
+
+        // The entry of 0 is left empty, 0 never reaching 1.
+        const CollatzSequence seq;
+
+        ThreadPool::global().parallelFor(1, uint64_t(1) << bits, 0,
+            [&](const uint64_t begin, const uint64_t end) {
+                Sequence::vec_t uz = { 0 };
+
+                for (uint64_t i = begin; i < end; ++i) {
+                    uz.front() = static_cast<int64_t>(i);
+                    const Result result = seq.doUntil(1, uz);
+                    unsigned char* entry = m_owned.data() + i * entrySize;
+
+                    put(entry, static_cast<uint64_t>(result.maxTerm), 8);
+                    put(entry + 8, result.cycleLen, 2);
+                }
+            });
+    }
+
+    StoppingTable::StoppingTable(const std::string& path)
+        : m_bits(0)
+        , m_limit(0)
+        , m_owned()
+        , m_file()
+        , m_data(nullptr)
+    {
+        m_file = core::MappedFile(path, "StoppingTable::StoppingTable()");
+        m_file.checkHeader(magic, version, headerSize,
+                           "Not a stopping table file.");
+        m_bits = core::varint::getFixed<uint32_t>(m_file.data() + 12);
+
+        if ((m_bits == 0) || (m_bits > maxBits))
+            throw m_file.error("Invalid number of bits.");
+
+        if (m_file.size() - headerSize != length(m_bits))
+            throw m_file.error("Truncated stopping table.");
+
+        m_limit = int64_t(1) << m_bits;
+        m_data = m_file.data() + headerSize;
+    }
+
+    void StoppingTable::save(const std::string& path) const
+    {
+        using core::varint::putFixed;
+
+        std::vector<unsigned char> header(magic, magic + 8);
+        putFixed<uint32_t>(header, version);
+        putFixed<uint32_t>(header, m_bits);
+
+        core::replaceFile(path, { { header.data(), header.size() },
+                                  { m_data, length(m_bits) } },
+                          "StoppingTable::save()");
+    }
+}
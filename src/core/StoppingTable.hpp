@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_STOPPING_TABLE_HPP
+#define SYRACUSE_STOPPING_TABLE_HPP
+
+#include "config-syracuse.hpp"
+#include "core/MappedFile.hpp"
+#include "core/Sequence.hpp"
+#include "core/Varint.hpp"
+
+#include <string>
+
+namespace sequence
+{
+    /**
+     * @class StoppingTable core/StoppingTable.hpp core/StoppingTable.hpp
+     * @brief A dense table of the runs of the Syracuse sequence reaching 1
+     * from the low initial terms.
+     *
+     * Unlike a \p ResultCache, which is filled by the runs as they go,
+     * the table holds the result of every initial term lower than
+     * \f$2^k\f$ from the start. A run reaching 1 can thus stop as soon as
+     * one of its terms falls below \f$2^k\f$, which most of them do long
+     * before reaching 1.
+     *
+     * The table is built by the threads of `ThreadPool::global()`. It can
+     * then be saved to a file and mapped in memory on the next runs, the
+     * pages being only read from the disk once looked up.
+     *
+     * @par Format
+     * The file starts with a header of 16 bytes:
+     *
+     * | Offset | Type       | Content                     |
+     * |--------|------------|-----------------------------|
+     * | 0      | `char[8]`  | `"SYRSTOPS"`                |
+     * | 8      | `uint32_t` | the version, currently 1    |
+     * | 12     | `uint32_t` | the number \f$k\f$ of bits  |
+     *
+     * The \f$2^k\f$ entries follow, each one made of the maximum term as
+     * an `int64_t` and of the length of the cycle as an `uint16_t`. All
+     * the integers are little-endian.
+     *
+     * @par Example
+     *
+     * ```cpp
+     * auto table = std::make_shared<const sequence::StoppingTable>(20);
+     * sequence::CollatzSequence mySeq(1);
+     * mySeq.withStoppingTable(table).loadNUntil(1000000, 1);
+     * ```
+     */
+    class StoppingTable
+    {
+    public:
+        /**
+         * @brief Type containing the statistics of a run.
+         */
+        using Result = Sequence::Result;
+
+        /**
+         * @brief The greatest number of bits of a table, which then takes
+         * 40 GiB.
+         *
+         * All the runs from below \f$2^{32}\f$ take less than \f$2^{16}\f$
+         * steps and stay within 64 bits.
+         */
+        static constexpr unsigned int maxBits = 32;
+        /**
+         * @brief The number of bytes of the header of a file.
+         */
+        static constexpr std::size_t headerSize = 16;
+        /**
+         * @brief The number of bytes of an entry.
+         */
+        static constexpr std::size_t entrySize = 10;
+        /**
+         * @brief The magic number starting a file.
+         */
+        static constexpr char magic[9] = "SYRSTOPS";
+        /**
+         * @brief The version of the format of the files.
+         */
+        static constexpr uint32_t version = 1;
+    public:
+        /**
+         * @brief Build the table.
+         *
+         * @warning
+         * \p bits must be between 1 and \p maxBits, or otherwise an
+         * `std::invalid_argument` will be thrown.
+         *
+         * @param bits the number \f$k\f$ of bits of the initial terms
+         */
+        explicit StoppingTable(const unsigned int bits =
+                                   SYRACUSE_STOPPING_BITS);
+        /**
+         * @brief Map a table saved by `save()`.
+         *
+         * @exception std::runtime_error if the file cannot be mapped or is
+         * not a valid table file
+         *
+         * @param path the path of the file
+         */
+        explicit StoppingTable(const std::string& path);
+        StoppingTable(const StoppingTable&) = delete;
+        StoppingTable& operator=(const StoppingTable&) = delete;
+
+        /**
+         * @brief Get the number of bits of the initial terms.
+         *
+         * @return the number \f$k\f$ of bits
+         */
+        unsigned int bits() const { return m_bits; }
+        /**
+         * @brief Get the initial term from which the results are not held.
+         *
+         * @return \f$2^k\f$
+         */
+        int64_t limit() const { return m_limit; }
+
+        /**
+         * @brief Look for the result of the run from an initial term until
+         * 1.
+         *
+         * @param uz     the initial term
+         * @param result the found result
+         * @return       `true` if \p uz is strictly positive and lower than
+         *               `limit()`
+         */
+        inline bool find(const int64_t uz, Result& result) const;
+
+        /**
+         * @brief Save the table.
+         *
+         * The file is replaced at once, so that an interruption leaves the
+         * previous one intact.
+         *
+         * @exception std::runtime_error if the file cannot be written
+         *
+         * @param path the path of the file
+         */
+        void save(const std::string& path) const;
+    private:
+        unsigned int m_bits;
+        int64_t m_limit;
+        std::vector<unsigned char> m_owned;
+        core::MappedFile m_file;
+        const unsigned char* m_data;
+    };
+
+    inline bool StoppingTable::find(const int64_t uz, Result& result) const
+    {
+        if ((uz <= 0) || (uz >= m_limit))
+            return false;
+
+        using core::varint::getFixed;
+
+        const unsigned char* entry =
+            m_data + static_cast<std::size_t>(uz) * entrySize;
+
+        result.maxTerm = getFixed<int64_t>(entry);
+        result.cycleLen = getFixed<uint16_t>(entry + 8);
+        return true;
+    }
+}
+
+#endif // SYRACUSE_STOPPING_TABLE_HPP
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_SUMMARY_HPP
+#define SYRACUSE_SUMMARY_HPP
+
+#include "core/Sequence.hpp"
+
+#include <limits>
+
+namespace sequence
+{
+    /**
+     * @struct Summary core/Summary.hpp core/Summary.hpp
+     * @brief The aggregated statistics of several runs.
+     *
+     * The runs are identified by their ordinal in a sweep. Summaries can
+     * be merged in any order: on a tie, the record kept is always the one
+     * of the lowest ordinal.
+     */
+    struct Summary
+    {
+        /**
+         * @brief Type representing the ordinal of a run.
+         */
+        using size_type = uint64_t;
+
+        /**
+         * @brief The number of runs.
+         */
+        size_type runs = 0;
+        /**
+         * @brief The sum of the lengths of the cycles.
+         */
+        uint64_t totalCycleLen = 0;
+        /**
+         * @brief The longest cycle.
+         */
+        Sequence::vec_t::size_type longestCycleLen = 0;
+        /**
+         * @brief The ordinal of the run having the longest cycle.
+         */
+        size_type longestRun = 0;
+        /**
+         * @brief The highest maximum term.
+         */
+        int128_t highestMaxTerm = std::numeric_limits<int64_t>::min();
+        /**
+         * @brief The ordinal of the run having the highest maximum term.
+         */
+        size_type highestRun = 0;
+
+        /**
+         * @brief Add a run.
+         *
+         * @param i      the ordinal of the run
+         * @param result the statistics of the run
+         */
+        inline void add(const size_type i, const Sequence::WideResult& result);
+        /**
+         * @brief Merge the runs of another summary.
+         *
+         * @param other the summary to merge
+         */
+        inline void merge(const Summary& other);
+    };
+
+    inline void Summary::add(const size_type i,
+                             const Sequence::WideResult& result)
+    {
+        merge(Summary{ 1, result.cycleLen, result.cycleLen, i, result.maxTerm,
+                       i });
+    }
+
+    inline void Summary::merge(const Summary& other)
+    {
+        if (other.runs == 0)
+            return;
+
+        if ((runs == 0) || (other.longestCycleLen > longestCycleLen)
+            || ((other.longestCycleLen == longestCycleLen)
+                && (other.longestRun < longestRun))) {
+            longestCycleLen = other.longestCycleLen;
+            longestRun = other.longestRun;
+        }
+
+        if ((runs == 0) || (other.highestMaxTerm > highestMaxTerm)
+            || ((other.highestMaxTerm == highestMaxTerm)
+                && (other.highestRun < highestRun))) {
+            highestMaxTerm = other.highestMaxTerm;
+            highestRun = other.highestRun;
+        }
+
+        runs += other.runs;
+        totalCycleLen += other.totalCycleLen;
+    }
+}
+
+#endif // SYRACUSE_SUMMARY_HPP
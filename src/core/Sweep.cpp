@@ -0,0 +1,260 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/Sweep.hpp"
+
+#include "core/Checkpoint.hpp"
+#include "core/Engine.hpp"
+#include "core/Metrics.hpp"
+#include "core/ResultTable.hpp"
+#include "core/SweepJob.hpp"
+#include "core/ThreadPool.hpp"
+
+#include <algorithm>
+#include <map>
+
+namespace sequence
+{
+    Sweep::~Sweep() = default;
+
+    Sweep::size_type Sweep::window() const
+    {
+        if (m_window != 0)
+            return m_window;
+
+        // Enough blocks for every thread to keep busy while the sink works
+        // on the oldest one.
+        return 2 * ThreadPool::global().size() + 1;
+    }
+
+    void Sweep::run(const size_type n, const sink_t& sink) const
+    {
+        if (n == 0)
+            return;
+
+        // A block computed and not given to the sink yet, along with the
+        // summary recorded by the checkpoint.
+        struct Block
+        {
+            Ref<ResultTable> table;
+            Summary summary;
+        };
+
+        // The state is shared with the tasks, so that it lives until the
+        // last of them has released its lock.
+        struct State
+        {
+            std::mutex mutex;
+            std::condition_variable cond;
+            std::map<size_type, Block> ready;
+            // The tables given to the sink, reused by the next blocks and
+            // released along with the state.
+            core::Pool<Ref<ResultTable>> tables;
+            size_type running = 0;
+            bool stop = false;
+            // Whether a block has been skipped because of the stop token.
+            bool cancelled = false;
+            std::exception_ptr error;
+        };
+
+        auto state = std::make_shared<State>();
+        const size_type blocks = (n - 1) / m_blockSize + 1;
+        const size_type held = window();
+        const Ref<Checkpoint> checkpoint = m_checkpoint;
+        const Ref<const Engine> engine = m_engine ? m_engine
+                                                  : Engine::make("scalar");
+        const core::StopToken token = m_stopToken;
+
+        if (checkpoint)
+            checkpoint->open(uz(), m_value, m_step, n, m_blockSize);
+
+        // Gives the first block not done before the checkpoint was opened.
+        const auto skip = [&](size_type block) {
+            while ((block < blocks) && checkpoint && checkpoint->isDone(block))
+                ++block;
+
+            return block;
+        };
+
+        const auto submit = [&](const size_type block) {
+            const size_type first = block * m_blockSize;
+            const size_type size = std::min(m_blockSize, n - first);
+
+            Sequence::vec_t uz = this->uz();
+            for (auto& i : uz)
+                i += static_cast<int64_t>(first) * m_step;
+
+            ++state->running;
+            ThreadPool::global().submit(
+                [this, state, checkpoint, engine, token, block, first, size,
+                 uz = std::move(uz)]() {
+                    Ref<ResultTable> table;
+                    Summary summary;
+                    std::exception_ptr error;
+                    bool cancelled = false;
+
+                    try {
+                        bool stop;
+                        {
+                            std::lock_guard<std::mutex> lock(state->mutex);
+                            cancelled = !state->stop && token.stopRequested();
+                            stop = state->stop || cancelled;
+
+                            if (!stop)
+                                table = state->tables.take();
+                        }
+
+                        if (table) {
+                            table->reset(uz, size);
+                        } else if (!stop) {
+                            table = std::make_shared<ResultTable>(uz, m_step,
+                                                                  size);
+                        }
+
+                        if (!stop) {
+                            {
+                                const Metrics::Chunk chunk(size);
+                                engine->run(m_seq, m_value, *table);
+                            }
+
+                            if constexpr (Metrics::enabled) {
+                                uint64_t steps = 0;
+
+                                for (size_type i = 0; i < size; ++i)
+                                    steps += table->cycleLen(i);
+
+                                Metrics::add(Metrics::Steps, steps);
+                            }
+
+                            // The block is only recorded as done by the
+                            // driver, once given to the sink.
+                            if (checkpoint) {
+                                for (size_type i = 0; i < size; ++i) {
+                                    summary.add(first + i,
+                                                { table->cycleLen(i),
+                                                  table->wideMaxTerm(i) });
+                                }
+                            }
+                        }
+                    } catch (...) {
+                        error = std::current_exception();
+                    }
+
+                    std::lock_guard<std::mutex> lock(state->mutex);
+
+                    if (error && !state->error) {
+                        state->error = error;
+                        state->stop = true;
+                    } else if (table) {
+                        state->ready.emplace(block,
+                                             Block{ std::move(table),
+                                                    summary });
+                    }
+
+                    state->cancelled = state->cancelled || cancelled;
+
+                    --state->running;
+                    state->cond.notify_all();
+                });
+        };
+
+        try {
+            size_type next = skip(0);
+            size_type submitted = next;
+            size_type pending = 0;
+
+            while ((next < blocks) && !token.stopRequested()) {
+                Block done;
+
+                {
+                    std::unique_lock<std::mutex> lock(state->mutex);
+
+                    // The blocks following the awaited one are computed
+                    // meanwhile, up to the size of the reorder window.
+                    while ((submitted < blocks) && (pending < held)) {
+                        submit(submitted);
+                        submitted = skip(submitted + 1);
+                        ++pending;
+                    }
+
+                    state->cond.wait(lock, [&] {
+                        return state->error || state->cancelled
+                               || (state->ready.count(next) != 0);
+                    });
+
+                    if (state->error || state->cancelled)
+                        break;
+
+                    const auto it = state->ready.find(next);
+                    done = std::move(it->second);
+                    state->ready.erase(it);
+                }
+
+                // The blocks left in the reorder window when the sweep
+                // stops are thus run again on resuming.
+                if (checkpoint) {
+                    checkpoint->complete(next, done.summary,
+                                         [&] { sink(*done.table); });
+                } else {
+                    sink(*done.table);
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->tables.give(std::move(done.table));
+                }
+
+                next = skip(next + 1);
+                --pending;
+            }
+
+            // The blocks queued once stopped are skipped.
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->stop = true;
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+
+            if (!state->error)
+                state->error = std::current_exception();
+
+            state->stop = true;
+        }
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->cond.wait(lock, [&] { return state->running == 0; });
+
+        // The blocks done are saved even if the sweep failed.
+        if (checkpoint) {
+            try {
+                checkpoint->close();
+            } catch (...) {
+                if (!state->error)
+                    state->error = std::current_exception();
+            }
+        }
+
+        if (state->error)
+            std::rethrow_exception(state->error);
+    }
+
+    Ref<SweepJob> Sweep::start(const size_type n, const sink_t& sink,
+                               const done_t& done) const
+    {
+        return std::make_shared<SweepJob>(*this, n, sink, done);
+    }
+}
@@ -0,0 +1,290 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_SWEEP_HPP
+#define SYRACUSE_SWEEP_HPP
+
+#include "core/Sequence.hpp"
+#include "core/StopToken.hpp"
+
+#include <exception>
+
+namespace sequence
+{
+    class Checkpoint;
+    class Engine;
+    class ResultTable;
+    class SweepJob;
+
+    /**
+     * @class Sweep core/Sweep.hpp core/Sweep.hpp
+     * @brief A run of `doUntil()` over a range of initial terms whose
+     * results are streamed.
+     *
+     * Unlike `Sequence::loadNUntil()`, the results are not kept until the
+     * end: the range is split into blocks evaluated by the threads of
+     * `ThreadPool::global()`, and each block is handed to a sink as soon
+     * as it and all the blocks before it are done. At most `window()`
+     * blocks are held at once, so that the memory used does not depend on
+     * the size of the range.
+     *
+     * The blocks are evaluated by an \p Engine, the `"scalar"` one by
+     * default.
+     *
+     * A sweep is either run by the calling thread through `run()`, which
+     * waits for it, or in the background through `start()`, which returns
+     * a \p SweepJob at once.
+     *
+     * @par Example
+     *
+     * ```cpp
+     * sequence::CollatzSequence mySeq(1);
+     * sequence::Sweep(mySeq, 1).run(10000000000,
+     *     [](const sequence::ResultTable& block) {
+     *         // write the block
+     *     });
+     * ```
+     */
+    class Sweep
+    {
+    public:
+        /**
+         * @brief Type representing a number of runs.
+         */
+        using size_type = uint64_t;
+        /**
+         * @brief Type representing the consumer of the blocks.
+         *
+         * The blocks are given in the order of their initial terms, from
+         * the thread calling `run()`. Each block is a table whose first
+         * initial terms are the ones of its first run.
+         */
+        using sink_t = std::function<void(const ResultTable&)>;
+        /**
+         * @brief Type representing the consumer of the end of a sweep run
+         * by `start()`.
+         *
+         * It is given the exception that stopped the sweep, or `nullptr`
+         * if the sweep is done or has been cancelled.
+         */
+        using done_t = std::function<void(const std::exception_ptr&)>;
+    public:
+        /**
+         * @brief Construct a sweep.
+         *
+         * The sequence is not copied and must outlive the sweep. Its
+         * initial terms are the ones of the first run, unless `withUz()`
+         * sets other ones.
+         *
+         * @param seq   the sequence to run
+         * @param value run the sequence until
+         * @param step  the step incrementing the initial terms
+         */
+        Sweep(const Sequence& seq, const int64_t value, const int64_t step = 1)
+            : m_seq(seq)
+            , m_value(value)
+            , m_step(step)
+            , m_uz()
+            , m_blockSize(defaultBlockSize)
+            , m_window(0)
+            , m_checkpoint()
+            , m_engine()
+            , m_stopToken() {}
+        /**
+         * @brief Release the checkpoint, the engine and the stop token.
+         */
+        ~Sweep();
+
+        /**
+         * @brief Set the initial terms of the first run.
+         *
+         * @param uz the initial terms, or an empty vector for the ones of
+         *           the sequence
+         * @return   a reference to the modified object
+         */
+        Sweep& withUz(const Sequence::vec_t& uz)
+        {
+            m_uz = uz;
+            return *this;
+        }
+        /**
+         * @brief Set the number of runs per block.
+         *
+         * @param n the number of runs, or 0 for the default one
+         * @return  a reference to the modified object
+         */
+        inline Sweep& withBlockSize(const size_type n);
+        /**
+         * @brief Set the maximum number of blocks held at once.
+         *
+         * @param n the number of blocks, or 0 to choose it from the number
+         *          of threads
+         * @return  a reference to the modified object
+         */
+        Sweep& withWindow(const size_type n)
+        {
+            m_window = n;
+            return *this;
+        }
+
+        /**
+         * @brief Set the checkpoint saving the progress of the sweep.
+         *
+         * @param checkpoint the checkpoint, or `nullptr` to save nothing
+         * @return           a reference to the modified object
+         */
+        Sweep& withCheckpoint(const Ref<Checkpoint>& checkpoint)
+        {
+            m_checkpoint = checkpoint;
+            return *this;
+        }
+
+        /**
+         * @brief Set the engine evaluating the blocks.
+         *
+         * @param engine the engine, or `nullptr` for the `"scalar"` one
+         * @return       a reference to the modified object
+         */
+        Sweep& withEngine(const Ref<const Engine>& engine)
+        {
+            m_engine = engine;
+            return *this;
+        }
+
+        /**
+         * @brief Get the initial terms of the first run.
+         *
+         * @return the initial terms
+         */
+        const Sequence::vec_t& uz() const
+        {
+            return m_uz.empty() ? m_seq.uz() : m_uz;
+        }
+        /**
+         * @brief Set the token stopping the sweep.
+         *
+         * The token is checked before each block: once its stop has been
+         * requested, the blocks not yet started are skipped and `run()`
+         * returns as soon as the running ones are done, without giving
+         * them to the sink. With a checkpoint, the blocks not given to the
+         * sink are not recorded as done, and are run again on resuming.
+         * The token is not used by `start()`, the job replacing it by its
+         * own, stopped by `SweepJob::cancel()`.
+         *
+         * @param token the token, or a default one not to stop
+         * @return      a reference to the modified object
+         */
+        Sweep& withStopToken(const core::StopToken& token)
+        {
+            m_stopToken = token;
+            return *this;
+        }
+
+        /**
+         * @brief Get the number of runs per block.
+         *
+         * @return the number of runs
+         */
+        size_type blockSize() const { return m_blockSize; }
+        /**
+         * @brief Get the maximum number of blocks held at once.
+         *
+         * @return the number of blocks
+         */
+        size_type window() const;
+        /**
+         * @brief Get the engine evaluating the blocks.
+         *
+         * @return the engine, or `nullptr` for the `"scalar"` one
+         */
+        const Ref<const Engine>& engine() const { return m_engine; }
+        /**
+         * @brief Get the token stopping the sweep.
+         *
+         * @return the token
+         */
+        const core::StopToken& stopToken() const { return m_stopToken; }
+
+        /**
+         * @brief Run the sweep and wait for it.
+         *
+         * @note
+         * If a block or the sink throws an exception, the blocks not yet
+         * started are skipped and the first exception is rethrown once the
+         * running ones are done.
+         *
+         * @note
+         * With a checkpoint, the blocks it records as done are skipped, and
+         * it is closed before returning, even if the sweep was stopped by
+         * its token. A block is only recorded once the sink has returned
+         * from it, so that a stopped or failed sweep resumes from the
+         * first block not given to the sink.
+         *
+         * @warning
+         * This method waits for the threads of `ThreadPool::global()`, and
+         * thus must not be called from one of them.
+         *
+         * @param n    the number of runs
+         * @param sink the consumer of the blocks
+         */
+        void run(const size_type n, const sink_t& sink) const;
+        /**
+         * @brief Start the sweep in the background.
+         *
+         * The sweep is driven by a thread of the job, the same way as by
+         * `run()`, so that the sink is given the blocks in order from this
+         * thread. The stop token of the sweep is replaced by the one of the
+         * job.
+         *
+         * @warning
+         * The sequence must outlive the job.
+         *
+         * @param n    the number of runs
+         * @param sink the consumer of the blocks
+         * @param done the consumer of the end of the sweep, called from
+         *             the thread of the job before `SweepJob::isDone()`
+         *             becomes `true`, or `nullptr`
+         * @return     a pointer to the job
+         */
+        Ref<SweepJob> start(const size_type n, const sink_t& sink,
+                            const done_t& done = nullptr) const;
+    public:
+        /**
+         * @brief The number of runs per block used by default.
+         */
+        static constexpr size_type defaultBlockSize = 1 << 16;
+    private:
+        const Sequence& m_seq;
+        int64_t m_value;
+        int64_t m_step;
+        Sequence::vec_t m_uz;
+        size_type m_blockSize;
+        size_type m_window;
+        Ref<Checkpoint> m_checkpoint;
+        Ref<const Engine> m_engine;
+        core::StopToken m_stopToken;
+    };
+
+    inline Sweep& Sweep::withBlockSize(const size_type n)
+    {
+        m_blockSize = (n == 0) ? defaultBlockSize : n;
+        return *this;
+    }
+}
+
+#endif // SYRACUSE_SWEEP_HPP
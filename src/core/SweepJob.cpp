@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/SweepJob.hpp"
+
+#include "core/ResultTable.hpp"
+
+namespace sequence
+{
+    SweepJob::SweepJob(const Sweep& sweep, const size_type n,
+                       const Sweep::sink_t& sink, const Sweep::done_t& done)
+        : m_source()
+        , m_total(n)
+        , m_done(0)
+        , m_mutex()
+        , m_cond()
+        , m_over(false)
+        , m_error()
+        , m_thread()
+    {
+        Sweep copy = sweep;
+        copy.withStopToken(m_source.token());
+
+        // Sweep::run() waits for the thread pool, and thus does not run in
+        // it. The thread is started last, once the members it uses exist.
+        m_thread = std::thread([this, copy, n, sink, done] {
+            std::exception_ptr error;
+
+            try {
+                copy.run(n, [&](const ResultTable& block) {
+                    sink(block);
+                    m_done.fetch_add(block.size(), std::memory_order_relaxed);
+                });
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            if (done)
+                done(error);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_error = error;
+            m_over = true;
+            m_cond.notify_all();
+        });
+    }
+
+    SweepJob::~SweepJob()
+    {
+        cancel();
+        m_thread.join();
+    }
+
+    bool SweepJob::isDone() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_over;
+    }
+
+    void SweepJob::wait() const
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cond.wait(lock, [this] { return m_over; });
+
+        if (m_error)
+            std::rethrow_exception(m_error);
+    }
+
+    bool SweepJob::waitFor(const std::chrono::milliseconds timeout) const
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_cond.wait_for(lock, timeout, [this] { return m_over; });
+    }
+}
@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_SWEEP_JOB_HPP
+#define SYRACUSE_SWEEP_JOB_HPP
+
+#include "core/Sweep.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace sequence
+{
+    /**
+     * @class SweepJob core/SweepJob.hpp core/SweepJob.hpp
+     * @brief A \p Sweep run in the background.
+     *
+     * The job is driven by a thread of its own, the blocks being evaluated
+     * by `ThreadPool::global()`, so that it can be started from any
+     * thread, including the event loop of a GUI. It can be polled for its
+     * progress, waited for, or cancelled: the cancellation is checked
+     * before each block, so that the job only waits for the blocks already
+     * running.
+     *
+     * @par Example
+     *
+     * ```cpp
+     * sequence::CollatzSequence mySeq(1);
+     * auto job = sequence::Sweep(mySeq, 1).start(10000000000,
+     *     [](const sequence::ResultTable& block) {
+     *         // write the block
+     *     });
+     *
+     * while (!job->waitFor(std::chrono::seconds(1)))
+     *     std::cout << job->progress().done << " runs\n";
+     *
+     * job->wait();  // rethrows the error of the sweep, if any
+     * ```
+     */
+    class SweepJob
+    {
+    public:
+        /**
+         * @brief Type representing a number of runs.
+         */
+        using size_type = Sweep::size_type;
+
+        /**
+         * @struct Progress core/SweepJob.hpp
+         * @brief The progress of a job.
+         */
+        struct Progress
+        {
+            /**
+             * @var size_type done
+             * The number of runs given to the sink, not counting the ones
+             * skipped by a checkpoint.
+             */
+            size_type done;
+            /**
+             * @var size_type total
+             * The number of runs of the sweep.
+             */
+            size_type total;
+        };
+    public:
+        /**
+         * @brief Start a job.
+         *
+         * The copy of the sweep is stopped by `cancel()`: any token
+         * already given to `sweep` by `Sweep::withStopToken()` is replaced,
+         * and requesting its stop has no effect on the job.
+         *
+         * @see Sweep::start()
+         *
+         * @param sweep the sweep, which is copied
+         * @param n     the number of runs
+         * @param sink  the consumer of the blocks
+         * @param done  the consumer of the end of the sweep, or `nullptr`
+         */
+        SweepJob(const Sweep& sweep, const size_type n,
+                 const Sweep::sink_t& sink,
+                 const Sweep::done_t& done = nullptr);
+        SweepJob(const SweepJob&) = delete;
+        SweepJob& operator=(const SweepJob&) = delete;
+        /**
+         * @brief Cancel the job and wait for it.
+         *
+         * @warning
+         * The job must not be destructed from its sink or from the
+         * consumer of its end.
+         */
+        ~SweepJob();
+
+        /**
+         * @brief Ask the job to stop.
+         *
+         * The blocks not yet started are skipped, and the ones running are
+         * not given to the sink.
+         */
+        void cancel() { m_source.requestStop(); }
+        /**
+         * @brief Check whether the job has been asked to stop.
+         *
+         * @return `true` if `cancel()` has been called
+         */
+        bool isCancelled() const { return m_source.stopRequested(); }
+        /**
+         * @brief Check whether the job is over.
+         *
+         * @return `true` if the sweep is done, has been cancelled or has
+         *         failed
+         */
+        bool isDone() const;
+        /**
+         * @brief Get the progress of the job.
+         *
+         * @return the number of runs given to the sink so far out of the
+         *         number of runs of the sweep
+         */
+        Progress progress() const
+        {
+            return { m_done.load(std::memory_order_relaxed), m_total };
+        }
+
+        /**
+         * @brief Wait for the job.
+         *
+         * @warning
+         * This method must not be called from the sink or from the
+         * consumer of the end of the job.
+         *
+         * @exception any the exception that stopped the sweep
+         */
+        void wait() const;
+        /**
+         * @brief Wait for the job for a given time at most.
+         *
+         * Unlike `wait()`, this method does not rethrow the error of the
+         * sweep.
+         *
+         * @param timeout the maximum time to wait
+         * @return        `true` if the job is over
+         */
+        bool waitFor(const std::chrono::milliseconds timeout) const;
+    private:
+        core::StopSource m_source;
+        size_type m_total;
+        std::atomic<size_type> m_done;
+        mutable std::mutex m_mutex;
+        mutable std::condition_variable m_cond;
+        bool m_over;
+        std::exception_ptr m_error;
+        std::thread m_thread;
+    };
+}
+
+#endif // SYRACUSE_SWEEP_JOB_HPP
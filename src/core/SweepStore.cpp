@@ -0,0 +1,325 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/SweepStore.hpp"
+
+#include "core/BinaryWriter.hpp"
+#include "core/ResultCache.hpp"
+#include "core/ResultFile.hpp"
+#include "core/ResultTable.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+
+#include <dirent.h>
+#include <unistd.h>
+
+namespace sequence
+{
+    SweepStore::SweepStore(const std::string& directory,
+                           const std::string& relation)
+        : m_directory(directory)
+        , m_relation(relation)
+        , m_blockSize(Sweep::defaultBlockSize)
+        , m_engine()
+    {
+        // The name must not hold any `_`, so that the names of the segments
+        // of a relation never start like the ones of another relation.
+        const bool valid =
+            !relation.empty()
+            && std::all_of(relation.begin(), relation.end(),
+                           [](const unsigned char c) {
+                               return std::isalnum(c) || (c == '-')
+                                      || (c == '.');
+                           });
+
+        if (!valid) {
+            throw std::invalid_argument("SweepStore::SweepStore(): The name "
+                                        "of the relation must only hold "
+                                        "letters, digits, '-' and '.'.");
+        }
+    }
+
+    SweepStore::~SweepStore() = default;
+
+    SweepStore::Report SweepStore::run(const Sequence& seq, const size_type n,
+                                       const int64_t value, const int64_t step,
+                                       const sink_t& sink) const
+    {
+        Report report = { 0, 0 };
+
+        if (n == 0)
+            return report;
+
+        const Sequence::vec_t& uz = seq.uz();
+
+        if (uz.empty()) {
+            throw std::invalid_argument("SweepStore::run(): The sequence has "
+                                        "no initial terms.");
+        }
+
+        if (step == 0) {
+            throw std::invalid_argument("SweepStore::run(): The step must not "
+                                        "be null.");
+        }
+
+        // The segments of the series, along with the ordinal of their first
+        // run in the sweep, which is negative for the ones starting before
+        // it.
+        std::vector<std::pair<int128_t, Ref<const ResultFile>>> series;
+
+        for (const auto& path : segments()) {
+            Ref<const ResultFile> file;
+
+            // A segment that cannot be read is run and stored again.
+            try {
+                file = std::make_shared<const ResultFile>(path);
+            } catch (const std::runtime_error&) {
+                continue;
+            }
+
+            if ((file->value() != value) || (file->step() != step)
+                || (file->size() == 0) || (file->uz().size() != uz.size())) {
+                continue;
+            }
+
+            const int128_t shift = int128_t(file->uz().front()) - uz.front();
+            bool same = (shift % step == 0);
+
+            for (std::size_t i = 1; same && (i < uz.size()); ++i)
+                same = (int128_t(file->uz()[i]) - uz[i] == shift);
+
+            if (same)
+                series.emplace_back(shift / step, std::move(file));
+        }
+
+        // Stores the runs from the ordinal `done` as a new segment.
+        const auto compute = [&](const size_type done, const size_type count) {
+            Sequence::vec_t first = uz;
+            for (auto& i : first)
+                i += static_cast<int64_t>(done) * step;
+
+            const std::string path = this->path(first, value, step);
+            const std::string tmp = path + ".tmp";
+            std::FILE* file = std::fopen(tmp.c_str(), "wb");
+
+            if (file == nullptr) {
+                throw std::runtime_error("SweepStore::run(): " + tmp + ": "
+                                         + std::strerror(errno));
+            }
+
+            std::exception_ptr error;
+            size_type written = 0;
+
+            try {
+                BinaryWriter writer(file, value);
+
+                try {
+                    Sweep(seq, value, step)
+                        .withUz(first)
+                        .withBlockSize(m_blockSize)
+                        .withEngine(m_engine)
+                        .run(count, [&](const ResultTable& block) {
+                            writer.write(block);
+                            written += block.size();
+                            sink(block);
+                        });
+                } catch (...) {
+                    error = std::current_exception();
+                }
+
+                writer.close();
+            } catch (...) {
+                if (!error)
+                    error = std::current_exception();
+
+                written = 0;
+            }
+
+            // The segment replaces the file at once, so that an interrupted
+            // sweep never leaves a truncated one.
+            bool ok = (written != 0) && (std::fflush(file) == 0)
+                      && (::fsync(::fileno(file)) == 0);
+            ok = (std::fclose(file) == 0) && ok;
+            ok = ok && (std::rename(tmp.c_str(), path.c_str()) == 0);
+
+            if (!ok) {
+                const int err = errno;
+                std::remove(tmp.c_str());
+
+                if (!error && (written != 0)) {
+                    error = std::make_exception_ptr(
+                        std::runtime_error("SweepStore::run(): " + path + ": "
+                                           + std::strerror(err)));
+                }
+            }
+
+            if (error)
+                std::rethrow_exception(error);
+
+            report.computed += written;
+        };
+
+        size_type done = 0;
+
+        while (done < n) {
+            // The segment covering the next run that goes the furthest, or
+            // else the first one after it.
+            const ResultFile* best = nullptr;
+            int128_t end = done;
+            int128_t next = n;
+
+            for (const auto& [first, file] : series) {
+                const int128_t last = first + int128_t(file->size());
+
+                if ((first <= done) && (last > end)) {
+                    best = file.get();
+                    end = last;
+                } else if (first > done) {
+                    next = std::min(next, first);
+                }
+            }
+
+            if (best == nullptr) {
+                compute(done, static_cast<size_type>(next - done));
+                done = static_cast<size_type>(next);
+                continue;
+            }
+
+            const auto offset = static_cast<size_type>(
+                done - (end - int128_t(best->size())));
+            const auto count = static_cast<size_type>(
+                std::min(end, int128_t(n)) - done);
+
+            for (size_type i = 0; i < count; i += m_blockSize)
+                sink(*best->read(offset + i, std::min(m_blockSize, count - i)));
+
+            report.stored += count;
+            done += count;
+        }
+
+        return report;
+    }
+
+    Ref<ResultTable> SweepStore::loadNUntil(const Sequence& seq,
+                                            const size_type n,
+                                            const int64_t value,
+                                            const int64_t step) const
+    {
+        auto ret = std::make_shared<ResultTable>(seq.uz(), step, n);
+        size_type done = 0;
+
+        run(seq, n, value, step, [&](const ResultTable& block) {
+            for (std::size_t i = 0; i < block.size(); ++i) {
+                ret->set(done + i, Sequence::WideResult{
+                    block.cycleLen(i), block.wideMaxTerm(i) });
+            }
+
+            done += block.size();
+        });
+
+        return ret;
+    }
+
+    SweepStore::size_type SweepStore::warm(ResultCache& cache) const
+    {
+        size_type ret = 0;
+
+        for (const auto& path : segments()) {
+            Ref<const ResultFile> file;
+
+            try {
+                file = std::make_shared<const ResultFile>(path);
+            } catch (const std::runtime_error&) {
+                continue;
+            }
+
+            if ((file->value() != cache.value()) || (file->uz().size() != 1))
+                continue;
+
+            // Only the blocks holding some cached initial terms are read.
+            for (size_type begin = 0; begin < file->size();
+                 begin += file->blockSize()) {
+                const size_type count = std::min(file->blockSize(),
+                                                 file->size() - begin);
+                const int128_t a = file->uz(begin).front();
+                const int128_t b = a + int128_t(count - 1) * file->step();
+
+                if ((std::max(a, b) < 0) || (std::min(a, b) >= cache.limit()))
+                    continue;
+
+                const auto table = file->read(begin, count);
+
+                for (std::size_t i = 0; i < table->size(); ++i) {
+                    const int64_t uz = table->uz(i).front();
+
+                    if ((uz >= 0) && (uz < cache.limit())
+                        && !table->isWide(i)) {
+                        cache.insert(uz, (*table)[i]);
+                        ++ret;
+                    }
+                }
+            }
+        }
+
+        return ret;
+    }
+
+    std::string SweepStore::path(const Sequence::vec_t& uz,
+                                 const int64_t value, const int64_t step) const
+    {
+        std::string ret = m_directory + '/' + m_relation + "_v"
+                          + std::to_string(value) + "_s"
+                          + std::to_string(step);
+
+        for (const auto i : uz)
+            ret += '_' + std::to_string(i);
+
+        return ret + ".bin";
+    }
+
+    std::vector<std::string> SweepStore::segments() const
+    {
+        DIR* dir = ::opendir(m_directory.c_str());
+
+        if (dir == nullptr) {
+            throw std::runtime_error("SweepStore::segments(): " + m_directory
+                                     + ": " + std::strerror(errno));
+        }
+
+        const std::string prefix = m_relation + "_v";
+        std::vector<std::string> ret;
+
+        while (const dirent* entry = ::readdir(dir)) {
+            const std::string name = entry->d_name;
+
+            if ((name.size() > prefix.size() + 4)
+                && (name.compare(0, prefix.size(), prefix) == 0)
+                && (name.compare(name.size() - 4, 4, ".bin") == 0)) {
+                ret.push_back(m_directory + '/' + name);
+            }
+        }
+
+        ::closedir(dir);
+        std::sort(ret.begin(), ret.end());
+        return ret;
+    }
+}
@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_SWEEP_STORE_HPP
+#define SYRACUSE_SWEEP_STORE_HPP
+
+#include "core/Sweep.hpp"
+
+namespace sequence
+{
+    class Engine;
+    class ResultCache;
+    class ResultTable;
+
+    /**
+     * @class SweepStore core/SweepStore.hpp core/SweepStore.hpp
+     * @brief A directory of result files keeping the sweeps already run.
+     *
+     * The runs of a sweep are identified by the name of the recurrence
+     * relation, the target value, the step and the initial terms. The
+     * runs of the same relation, target value and step whose initial terms
+     * only differ by multiples of the step belong to the same series, and
+     * a series is stored as segments of consecutive runs, one result file
+     * per segment.
+     *
+     * A sweep only runs the parts of its range that no segment covers,
+     * and stores each of them as a new segment: running it again with a
+     * larger count, or over a higher range, does not run the first runs
+     * again.
+     *
+     * @par Example
+     *
+     * ```cpp
+     * sequence::CollatzSequence mySeq(1);
+     * sequence::SweepStore store("sweeps", "collatz");
+     *
+     * store.loadNUntil(mySeq, 1000000, 1);
+     * // only runs the initial terms from 1000001 to 2000000
+     * auto table = store.loadNUntil(mySeq, 2000000, 1);
+     * ```
+     *
+     * @warning
+     * The name of the relation is the only thing telling the relations
+     * apart: the results of a relation must not be stored under the name
+     * of another one.
+     */
+    class SweepStore
+    {
+    public:
+        /**
+         * @brief Type representing a number of runs.
+         */
+        using size_type = uint64_t;
+        /**
+         * @brief Type representing the consumer of the blocks.
+         *
+         * @see Sweep::sink_t
+         */
+        using sink_t = Sweep::sink_t;
+
+        /**
+         * @struct Report core/SweepStore.hpp
+         * @brief The outcome of a sweep.
+         */
+        struct Report
+        {
+            /**
+             * @var size_type stored
+             * The number of runs read from the stored segments.
+             */
+            size_type stored;
+            /**
+             * @var size_type computed
+             * The number of runs computed and stored as new segments.
+             */
+            size_type computed;
+        };
+    public:
+        /**
+         * @brief Construct a store.
+         *
+         * @exception std::invalid_argument if \p relation is empty or
+         * holds other characters than letters, digits, `-` and `.`
+         *
+         * @param directory the directory where the segments are stored,
+         *                  which must exist
+         * @param relation  the name of the recurrence relation
+         */
+        SweepStore(const std::string& directory, const std::string& relation);
+        /**
+         * @brief Release the engine.
+         */
+        ~SweepStore();
+
+        /**
+         * @brief Set the number of runs per block.
+         *
+         * The blocks are the ones given to the sinks, both for the runs
+         * read and for the runs computed.
+         *
+         * @param n the number of runs, or 0 for the default one of
+         *          \p Sweep
+         * @return  a reference to the modified object
+         */
+        SweepStore& withBlockSize(const size_type n)
+        {
+            m_blockSize = (n == 0) ? Sweep::defaultBlockSize : n;
+            return *this;
+        }
+        /**
+         * @brief Set the engine computing the runs not stored.
+         *
+         * @param engine the engine, or `nullptr` for the `"scalar"` one
+         * @return       a reference to the modified object
+         */
+        SweepStore& withEngine(const Ref<const Engine>& engine)
+        {
+            m_engine = engine;
+            return *this;
+        }
+
+        /**
+         * @brief Get the directory where the segments are stored.
+         *
+         * @return the path of the directory
+         */
+        const std::string& directory() const { return m_directory; }
+        /**
+         * @brief Get the name of the recurrence relation.
+         *
+         * @return the name
+         */
+        const std::string& relation() const { return m_relation; }
+        /**
+         * @brief Get the number of runs per block.
+         *
+         * @return the number of runs
+         */
+        size_type blockSize() const { return m_blockSize; }
+
+        /**
+         * @brief Run a sweep, reading the runs already stored and storing
+         * the other ones.
+         *
+         * The blocks are given to the sink in the order of their initial
+         * terms, as by `Sweep::run()`, whether they are read or computed.
+         *
+         * @note
+         * If the sweep fails while computing a part of the range, the runs
+         * of this part already given to the sink are stored nonetheless.
+         *
+         * @warning
+         * This method waits for the threads of `ThreadPool::global()`, and
+         * thus must not be called from one of them.
+         *
+         * @exception std::invalid_argument if the sequence has no initial
+         * terms or if \p step is null
+         * @exception std::runtime_error if the directory cannot be read or
+         * if a segment cannot be written
+         *
+         * @param seq   the sequence to run, whose initial terms are the ones
+         *              of the first run
+         * @param n     the number of runs
+         * @param value run the sequence until
+         * @param step  the step incrementing the initial terms
+         * @param sink  the consumer of the blocks
+         * @return      the numbers of runs read and computed
+         */
+        Report run(const Sequence& seq, const size_type n, const int64_t value,
+                   const int64_t step, const sink_t& sink) const;
+        /**
+         * @brief Run `doUntil()` several times, reading the runs already
+         * stored and storing the other ones.
+         *
+         * @see run()
+         *
+         * @param seq   the sequence to run, whose initial terms are the ones
+         *              of the first run
+         * @param n     run `doUntil()` \p n times
+         * @param value run the sequence until
+         * @param step  the step incrementing the initial terms
+         * @return      a pointer to a table where each \p Result is
+         *              associated with the initial terms
+         */
+        Ref<ResultTable> loadNUntil(const Sequence& seq, const size_type n,
+                                    const int64_t value,
+                                    const int64_t step = 1) const;
+        /**
+         * @brief Fill a cache with the stored runs.
+         *
+         * Only the runs of order 1 whose target value is the one of the
+         * cache are inserted, provided that their maximum term fits in 64
+         * bits.
+         *
+         * @exception std::runtime_error if the directory cannot be read
+         *
+         * @param cache the cache to fill
+         * @return      the number of runs inserted
+         */
+        size_type warm(ResultCache& cache) const;
+    private:
+        std::string path(const Sequence::vec_t& uz, const int64_t value,
+                         const int64_t step) const;
+        std::vector<std::string> segments() const;
+    private:
+        std::string m_directory;
+        std::string m_relation;
+        size_type m_blockSize;
+        Ref<const Engine> m_engine;
+    };
+}
+
+#endif // SYRACUSE_SWEEP_STORE_HPP
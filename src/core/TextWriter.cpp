@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/TextWriter.hpp"
+
+#include "core/ResultTable.hpp"
+
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+namespace sequence
+{
+    namespace
+    {
+        // The longest integers: an int64_t and a 128-bit maximum term.
+        constexpr std::size_t termLen = 20;
+        constexpr std::size_t wideLen = 40;
+    }
+
+    TextWriter::TextWriter(std::FILE* file, const std::size_t size)
+        : m_file(file)
+        , m_buffer(std::max<std::size_t>(size, 1 << 12))
+        , m_size(0)
+    {}
+
+    TextWriter::~TextWriter()
+    {
+        try {
+            flush();
+        } catch (...) {}
+    }
+
+    void TextWriter::write(const ResultTable& table)
+    {
+        auto uz = table.uz();
+        const auto step = table.step();
+        const std::size_t lineLen = (uz.size() + 1) * (termLen + 1)
+                                    + wideLen + 1;
+        char* const end = m_buffer.data() + m_buffer.size();
+
+        for (std::size_t i = 0; i < table.size(); ++i) {
+            if (m_buffer.size() - m_size < lineLen)
+                flush();
+
+            char* p = m_buffer.data() + m_size;
+
+            for (const auto j : uz) {
+                p = std::to_chars(p, end, j).ptr;
+                *p++ = ' ';
+            }
+
+            p = std::to_chars(p, end, table.cycleLen(i)).ptr;
+            *p++ = ' ';
+
+            if (table.isWide(i)) {
+                const std::string maxTerm = toString(table.wideMaxTerm(i));
+                p = std::copy(maxTerm.begin(), maxTerm.end(), p);
+            } else {
+                p = std::to_chars(p, end, table.maxTerm(i)).ptr;
+            }
+
+            *p++ = '\n';
+            m_size = static_cast<std::size_t>(p - m_buffer.data());
+
+            for (auto& j : uz)
+                j += step;
+        }
+    }
+
+    void TextWriter::flush()
+    {
+        if (m_size == 0)
+            return;
+
+        const std::size_t written = std::fwrite(m_buffer.data(), 1, m_size,
+                                                m_file);
+        const bool failed = (written != m_size);
+        m_size = 0;
+
+        if (failed || (std::fflush(m_file) != 0)) {
+            throw std::runtime_error(std::string("TextWriter::flush(): ")
+                                     + std::strerror(errno));
+        }
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_TEXT_WRITER_HPP
+#define SYRACUSE_TEXT_WRITER_HPP
+
+#include <cstdio>
+#include <vector>
+
+namespace sequence
+{
+    class ResultTable;
+
+    /**
+     * @class TextWriter core/TextWriter.hpp core/TextWriter.hpp
+     * @brief A buffered writer of results as text.
+     *
+     * Each run is written on its own line, as its initial terms followed
+     * by the length of its cycle and its maximum term, separated by
+     * spaces. The lines are formatted into a buffer of fixed size, which
+     * is written to the file once full.
+     */
+    class TextWriter
+    {
+    public:
+        /**
+         * @brief Construct a writer.
+         *
+         * The file is not closed by the writer.
+         *
+         * @param file the file to write to
+         * @param size the size of the buffer, in bytes
+         */
+        explicit TextWriter(std::FILE* file, const std::size_t size = 1 << 20);
+        TextWriter(const TextWriter&) = delete;
+        TextWriter& operator=(const TextWriter&) = delete;
+        /**
+         * @brief Flush the buffer, ignoring the errors.
+         */
+        ~TextWriter();
+
+        /**
+         * @brief Write the runs of a table.
+         *
+         * @exception std::runtime_error if the file cannot be written
+         *
+         * @param table the table to write
+         */
+        void write(const ResultTable& table);
+        /**
+         * @brief Write the content of the buffer to the file.
+         *
+         * @exception std::runtime_error if the file cannot be written
+         */
+        void flush();
+    private:
+        std::FILE* m_file;
+        std::vector<char> m_buffer;
+        std::size_t m_size;
+    };
+}
+
+#endif // SYRACUSE_TEXT_WRITER_HPP
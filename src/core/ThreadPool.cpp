@@ -0,0 +1,278 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/ThreadPool.hpp"
+
+#include <algorithm>
+#include <exception>
+
+#include <pthread.h>
+#include <sched.h>
+
+namespace core
+{
+    namespace
+    {
+        thread_local const ThreadPool* t_pool = nullptr;
+        thread_local std::size_t t_index = 0;
+    }
+
+    ThreadPool::ThreadPool(const unsigned int threads,
+                           const Topology& topology)
+        : m_queues()
+        , m_nodes()
+        , m_cpus()
+        , m_victims()
+        , m_threads()
+        , m_mutex()
+        , m_cond()
+        , m_pending(0)
+        , m_next(0)
+        , m_stop(false)
+    {
+        const unsigned int size = std::max(threads, 1u);
+
+        for (unsigned int i = 0; i < size; ++i)
+            m_queues.push_back(std::make_unique<Queue>());
+
+        // The threads are dealt to the nodes as their cores are, so that
+        // fewer threads than cores are still spread over all the nodes.
+        std::size_t cores = 0;
+        for (std::size_t i = 0; i < topology.size(); ++i)
+            cores += topology.cpus(i).size();
+
+        std::vector<std::size_t> slots;
+
+        for (std::size_t rank = 0; slots.size() < cores; ++rank) {
+            for (std::size_t i = 0; i < topology.size(); ++i) {
+                if (rank < topology.cpus(i).size())
+                    slots.push_back(i);
+            }
+        }
+
+        if (slots.empty())
+            slots.push_back(0);
+
+        for (unsigned int i = 0; i < size; ++i)
+            m_nodes.push_back(slots[i % slots.size()]);
+
+        // A single node is left to the scheduler.
+        if (topology.size() > 1) {
+            for (unsigned int i = 0; i < size; ++i)
+                m_cpus.push_back(topology.cpus(m_nodes[i]));
+        }
+
+        for (std::size_t i = 0; i < size; ++i) {
+            std::vector<std::size_t> victims;
+
+            for (const bool local : { true, false }) {
+                for (std::size_t j = 1; j < size; ++j) {
+                    const std::size_t victim = (i + j) % size;
+
+                    if ((m_nodes[victim] == m_nodes[i]) == local)
+                        victims.push_back(victim);
+                }
+            }
+
+            m_victims.push_back(std::move(victims));
+        }
+
+        for (std::size_t i = 0; i < size; ++i)
+            m_threads.emplace_back(&ThreadPool::work, this, i);
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+
+        m_cond.notify_all();
+
+        for (auto& i : m_threads)
+            i.join();
+    }
+
+    ThreadPool& ThreadPool::global()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    unsigned int ThreadPool::defaultSize()
+    {
+        return std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    void ThreadPool::submit(task_t task)
+    {
+        push(m_next++ % size(), std::move(task));
+    }
+
+    void ThreadPool::parallelFor(const uint64_t begin, const uint64_t end,
+                                 uint64_t chunk, const range_t& fn)
+    {
+        if (begin >= end)
+            return;
+
+        if (chunk == 0)
+            chunk = std::max<uint64_t>((end - begin) / (16 * size()), 1);
+
+        struct State
+        {
+            std::mutex mutex;
+            std::condition_variable done;
+            uint64_t remaining;
+            std::exception_ptr error;
+        };
+
+        const uint64_t chunks = (end - begin - 1) / chunk + 1;
+        auto state = std::make_shared<State>();
+        state->remaining = chunks;
+
+        for (uint64_t i = 0; i < chunks; ++i) {
+            const uint64_t first = begin + i * chunk;
+            const uint64_t last = std::min(first + chunk, end);
+
+            push(static_cast<std::size_t>(i % size()),
+                 [state, first, last, &fn] {
+                     std::exception_ptr error;
+
+                     try {
+                         fn(first, last);
+                     } catch (...) {
+                         error = std::current_exception();
+                     }
+
+                     std::lock_guard<std::mutex> lock(state->mutex);
+
+                     if (error && !state->error)
+                         state->error = error;
+
+                     if (--state->remaining == 0)
+                         state->done.notify_all();
+                 });
+        }
+
+        const std::size_t index = current();
+        std::unique_lock<std::mutex> lock(state->mutex);
+
+        if (index < size()) {
+            // A thread of the pool must not sleep while its own queue may
+            // hold the chunks, so that nested calls cannot deadlock.
+            while (state->remaining > 0) {
+                lock.unlock();
+
+                task_t task;
+                if (pop(index, task))
+                    task();
+                else
+                    std::this_thread::yield();
+
+                lock.lock();
+            }
+        } else {
+            state->done.wait(lock, [&] { return state->remaining == 0; });
+        }
+
+        if (state->error)
+            std::rethrow_exception(state->error);
+    }
+
+    bool ThreadPool::pop(const std::size_t index, task_t& task)
+    {
+        // The own queue is used as a stack to keep the data hot, while the
+        // others are stolen from the other end, the ones of the same node
+        // first.
+        for (std::size_t i = 0; i < size(); ++i) {
+            Queue& q = *m_queues[(i == 0) ? index : m_victims[index][i - 1]];
+            std::lock_guard<std::mutex> lock(q.mutex);
+
+            if (!q.tasks.empty()) {
+                if (i == 0) {
+                    task = std::move(q.tasks.back());
+                    q.tasks.pop_back();
+                } else {
+                    task = std::move(q.tasks.front());
+                    q.tasks.pop_front();
+                }
+
+                --m_pending;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void ThreadPool::push(const std::size_t index, task_t task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_pending;
+        }
+
+        {
+            Queue& q = *m_queues[index];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.tasks.push_back(std::move(task));
+        }
+
+        m_cond.notify_one();
+    }
+
+    void ThreadPool::work(const std::size_t index)
+    {
+        t_pool = this;
+        t_index = index;
+
+        // On failure, the thread is merely left to the scheduler.
+        if (!m_cpus.empty()) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+
+            for (const auto cpu : m_cpus[index]) {
+                if (cpu < CPU_SETSIZE)
+                    CPU_SET(cpu, &set);
+            }
+
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        }
+
+        for (;;) {
+            task_t task;
+
+            if (pop(index, task)) {
+                task();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cond.wait(lock, [this] { return m_stop || (m_pending > 0); });
+
+            if (m_stop && (m_pending == 0))
+                return;
+        }
+    }
+
+    std::size_t ThreadPool::current() const
+    {
+        return (t_pool == this) ? t_index : size();
+    }
+}
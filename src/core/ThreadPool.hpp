@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_THREAD_POOL_HPP
+#define SYRACUSE_THREAD_POOL_HPP
+
+#include "core/Topology.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace core
+{
+    /**
+     * @class ThreadPool core/ThreadPool.hpp core/ThreadPool.hpp
+     * @brief A pool of threads balancing the work by stealing.
+     *
+     * Each thread owns a queue of tasks: it runs the last task of its own
+     * queue first, and steals the first task of the other ones once it is
+     * empty. Hence, the work stays balanced even if the tasks do not last
+     * the same time, without creating more threads than there are cores.
+     *
+     * On a machine of several NUMA nodes, the threads are spread over the
+     * nodes of a \p Topology and each one is kept on the cores of its
+     * node. A thread steals from the threads of its own node before the
+     * ones of the other nodes, so that a task and the memory it writes
+     * tend to stay on the same node.
+     */
+    class ThreadPool
+    {
+    public:
+        /**
+         * @brief Type representing a task.
+         */
+        using task_t = std::function<void()>;
+        /**
+         * @brief Type representing a task run over a range \f$[begin,
+         * end)\f$.
+         */
+        using range_t = std::function<void(uint64_t, uint64_t)>;
+    public:
+        /**
+         * @brief Start the threads.
+         *
+         * @param threads  the number of threads
+         * @param topology the nodes the threads are spread over, which are
+         *                 only kept if there are several of them
+         */
+        explicit ThreadPool(const unsigned int threads = defaultSize(),
+                            const Topology& topology = Topology::system());
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        /**
+         * @brief Wait for the queued tasks and stop the threads.
+         */
+        ~ThreadPool();
+
+        /**
+         * @brief Get the pool shared by the whole program.
+         *
+         * @return a reference to the global pool
+         */
+        static ThreadPool& global();
+        /**
+         * @brief Get the number of threads used by default.
+         *
+         * @return the number of cores, or 1 if it is unknown
+         */
+        static unsigned int defaultSize();
+
+        /**
+         * @brief Get the number of threads.
+         *
+         * @return the number of threads
+         */
+        std::size_t size() const { return m_queues.size(); }
+        /**
+         * @brief Get the node of a thread.
+         *
+         * @param index the ordinal of the thread
+         * @return      the ordinal of its node in the topology of the pool
+         */
+        std::size_t node(const std::size_t index) const
+        {
+            return m_nodes[index];
+        }
+        /**
+         * @brief Get the number of tasks queued and not started yet.
+         *
+         * @return the number of tasks
+         */
+        int64_t pending() const
+        {
+            return m_pending.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Queue a task.
+         *
+         * @param task the task to run
+         */
+        void submit(task_t task);
+        /**
+         * @brief Run a task over a range split into chunks, and wait for
+         * it.
+         *
+         * @par Example
+         *
+         * ```cpp
+         * std::vector<int64_t> v(1000);
+         * core::ThreadPool::global().parallelFor(0, v.size(), 100,
+         *     [&](uint64_t begin, uint64_t end) {
+         *         for (auto i = begin; i < end; ++i)
+         *             v[i] = i * i;
+         *     });
+         * ```
+         *
+         * @note
+         * If a chunk throws an exception, the remaining chunks still run
+         * and the first exception is rethrown afterwards.
+         *
+         * @param begin the first index
+         * @param end   the index following the last one
+         * @param chunk the number of indexes given to a single task, or 0 to
+         *              choose it from the number of threads
+         * @param fn    the task to run over each chunk
+         */
+        void parallelFor(const uint64_t begin, const uint64_t end,
+                         uint64_t chunk, const range_t& fn);
+    private:
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<task_t> tasks;
+        };
+    private:
+        bool pop(const std::size_t index, task_t& task);
+        void push(const std::size_t index, task_t task);
+        void work(const std::size_t index);
+        std::size_t current() const;
+    private:
+        std::vector<std::unique_ptr<Queue>> m_queues;
+        // The node of each thread, the cores it is kept on, and the other
+        // threads to steal from, sorted from the nearest.
+        std::vector<std::size_t> m_nodes;
+        std::vector<std::vector<unsigned int>> m_cpus;
+        std::vector<std::vector<std::size_t>> m_victims;
+        std::vector<std::thread> m_threads;
+        std::mutex m_mutex;
+        std::condition_variable m_cond;
+        std::atomic<int64_t> m_pending;
+        std::atomic<std::size_t> m_next;
+        bool m_stop;
+    };
+}
+
+#endif // SYRACUSE_THREAD_POOL_HPP
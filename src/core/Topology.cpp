@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/Topology.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <sched.h>
+
+namespace core
+{
+    namespace
+    {
+        // Parses a list of cores such as "0-3,8-11".
+        std::vector<unsigned int> parse(const std::string& list)
+        {
+            std::vector<unsigned int> ret;
+            std::istringstream in(list);
+            std::string range;
+
+            while (std::getline(in, range, ',')) {
+                unsigned int first;
+                unsigned int last;
+                char dash;
+                std::istringstream r(range);
+
+                if (!(r >> first))
+                    continue;
+
+                if (!(r >> dash >> last) || (dash != '-'))
+                    last = first;
+
+                for (unsigned int i = first; i <= last; ++i)
+                    ret.push_back(i);
+            }
+
+            return ret;
+        }
+
+        std::string read(const std::string& path)
+        {
+            std::ifstream file(path);
+            std::string ret;
+            std::getline(file, ret);
+            return ret;
+        }
+
+        Topology discover()
+        {
+            cpu_set_t allowed;
+            CPU_ZERO(&allowed);
+
+            const bool affinity =
+                (sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+            const auto isAllowed = [&](const unsigned int cpu) {
+                return !affinity || ((cpu < CPU_SETSIZE)
+                                     && CPU_ISSET(cpu, &allowed));
+            };
+
+            const std::string sys = "/sys/devices/system/node/";
+            std::vector<std::vector<unsigned int>> nodes;
+            const std::vector<unsigned int> ids = parse(read(sys + "online"));
+
+            for (const auto node : ids) {
+                auto cpus = parse(read(sys + "node" + std::to_string(node)
+                                       + "/cpulist"));
+                cpus.erase(std::remove_if(cpus.begin(), cpus.end(),
+                                          [&](const unsigned int cpu) {
+                                              return !isAllowed(cpu);
+                                          }),
+                           cpus.end());
+                nodes.push_back(std::move(cpus));
+            }
+
+            Topology ret(nodes, ids);
+
+            if (ret.size() > 1)
+                return ret;
+
+            // A single node holds all the cores the process may run on.
+            std::vector<unsigned int> cpus;
+            const unsigned int count =
+                std::max(std::thread::hardware_concurrency(), 1u);
+
+            for (unsigned int i = 0; (i < CPU_SETSIZE) && affinity; ++i) {
+                if (CPU_ISSET(i, &allowed))
+                    cpus.push_back(i);
+            }
+
+            for (unsigned int i = 0; cpus.empty() && (i < count); ++i)
+                cpus.push_back(i);
+
+            return Topology({ cpus });
+        }
+    }
+
+    Topology::Topology(const std::vector<std::vector<unsigned int>>& nodes,
+                       const std::vector<unsigned int>& ids)
+        : m_nodes()
+        , m_ids()
+    {
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            if (!nodes[i].empty()) {
+                m_nodes.push_back(nodes[i]);
+                m_ids.push_back((i < ids.size())
+                                    ? ids[i]
+                                    : static_cast<unsigned int>(i));
+            }
+        }
+
+        if (m_nodes.empty()) {
+            m_nodes.emplace_back();
+            m_ids.push_back(0);
+        }
+    }
+
+    Topology::~Topology() = default;
+
+    const Topology& Topology::system()
+    {
+        static const Topology topology = discover();
+        return topology;
+    }
+
+    std::size_t Topology::lookup()
+    {
+        const Topology& topology = system();
+        const int cpu = sched_getcpu();
+
+        for (std::size_t i = 0; (cpu >= 0) && (i < topology.size()); ++i) {
+            const auto& cpus = topology.cpus(i);
+
+            if (std::find(cpus.begin(), cpus.end(),
+                          static_cast<unsigned int>(cpu)) != cpus.end()) {
+                return i;
+            }
+        }
+
+        return 0;
+    }
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_TOPOLOGY_HPP
+#define SYRACUSE_TOPOLOGY_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace core
+{
+    /**
+     * @class Topology core/Topology.hpp core/Topology.hpp
+     * @brief The NUMA nodes of the machine and their cores.
+     *
+     * On a machine of several sockets, the memory is split into nodes, each
+     * one being faster to reach from the cores of its own socket. The
+     * threads of a \p ThreadPool are thus kept on the cores of a node, and
+     * steal the tasks of the threads of the same node first. The memory
+     * being given by Linux to the node of the thread writing it first, the
+     * results of the tasks land on the node of the threads computing them.
+     *
+     * The topology of the machine is read from `/sys/devices/system/node`,
+     * keeping only the cores the process may run on. A machine without
+     * NUMA, or whose topology cannot be read, has a single node holding all
+     * its cores.
+     */
+    class Topology
+    {
+    public:
+        /**
+         * @brief Construct a topology.
+         *
+         * The nodes holding no core are dropped.
+         *
+         * @param nodes the cores of each node
+         * @param ids   the numbers given to the nodes by Linux, or an empty
+         *              vector for their ordinals
+         */
+        explicit Topology(const std::vector<std::vector<unsigned int>>& nodes,
+                          const std::vector<unsigned int>& ids = {});
+        Topology(const Topology&) = default;
+        Topology(Topology&&) = default;
+        Topology& operator=(const Topology&) = default;
+        Topology& operator=(Topology&&) = default;
+        /**
+         * @brief Destruct the topology.
+         */
+        ~Topology();
+
+        /**
+         * @brief Get the topology of the machine.
+         *
+         * The topology is read once, by the first call.
+         *
+         * @return a reference to the topology
+         */
+        static const Topology& system();
+        /**
+         * @brief Get the node of the calling thread in the topology of the
+         * machine.
+         *
+         * The node is looked up by the first call of each thread, from the
+         * core it runs on: it is only accurate for the threads that do not
+         * move from a node to another one, e.g. the ones of a
+         * \p ThreadPool.
+         *
+         * @return the ordinal of the node
+         */
+        static inline std::size_t currentNode();
+
+        /**
+         * @brief Get the number of nodes.
+         *
+         * @return the number of nodes, at least 1
+         */
+        std::size_t size() const { return m_nodes.size(); }
+        /**
+         * @brief Get the cores of a node.
+         *
+         * @param node the ordinal of the node
+         * @return     the cores, or an empty vector if they are unknown
+         */
+        const std::vector<unsigned int>& cpus(const std::size_t node) const
+        {
+            return m_nodes[node];
+        }
+        /**
+         * @brief Get the number given to a node by Linux.
+         *
+         * @param node the ordinal of the node
+         * @return     the number of the node, e.g. for `mbind()`
+         */
+        unsigned int id(const std::size_t node) const { return m_ids[node]; }
+    private:
+        static std::size_t lookup();
+    private:
+        std::vector<std::vector<unsigned int>> m_nodes;
+        std::vector<unsigned int> m_ids;
+    };
+
+    inline std::size_t Topology::currentNode()
+    {
+        static thread_local const std::size_t node = lookup();
+        return node;
+    }
+}
+
+#endif // SYRACUSE_TOPOLOGY_HPP
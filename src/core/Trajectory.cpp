@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/Trajectory.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace sequence
+{
+    int128_t Trajectory::at(const size_type rank) const
+    {
+        if (rank > m_steps) {
+            throw std::out_of_range("Trajectory::at(): The rank exceeds the "
+                                    "number of steps.");
+        }
+
+        size_type i = rank - rank % markInterval;
+        int128_t ret = m_marks[i / markInterval];
+
+        for (; i < rank; ++i)
+            ret = next(ret, odd(i));
+
+        return ret;
+    }
+
+    void Trajectory::terms(const size_type first, const size_type count,
+                           std::vector<int128_t>& terms) const
+    {
+        const int128_t uz = at(first);
+        const size_type n = std::min(count, m_steps - first + 1);
+
+        terms.resize(n);
+
+        if (n == 0)
+            return;
+
+        terms.front() = uz;
+
+        for (size_type i = 1; i < n; ++i)
+            terms[i] = next(terms[i - 1], odd(first + i - 1));
+    }
+}
@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_TRAJECTORY_HPP
+#define SYRACUSE_TRAJECTORY_HPP
+
+#include "core/Sequence.hpp"
+
+namespace sequence
+{
+    /**
+     * @class Trajectory core/Trajectory.hpp core/Trajectory.hpp
+     * @brief The whole trajectory of a run of the Syracuse sequence, stored
+     * as a string of parity bits.
+     *
+     * Each step of the sequence only depends on the parity of the current
+     * term, so that a trajectory is entirely given by its initial term and
+     * one bit per step. Every \p markInterval steps, the term reached is
+     * also kept, so that any term can be rebuilt on demand by replaying at
+     * most \p markInterval steps.
+     *
+     * A trajectory is filled by the recording mode of
+     * `CollatzSequence::doUntilWide()`. Filling the same object again
+     * reuses its storage.
+     *
+     * @par Example
+     *
+     * ```cpp
+     * sequence::Trajectory trajectory;
+     * sequence::CollatzSequence().doUntilWide(1, {27}, trajectory);
+     * trajectory.steps(); // returns 111
+     * trajectory.at(77);  // returns 9232, the maximum term
+     * ```
+     */
+    class Trajectory
+    {
+    public:
+        /**
+         * @brief Type representing a rank.
+         */
+        using size_type = Sequence::vec_t::size_type;
+        /**
+         * @brief Type representing a word of parity bits.
+         */
+        using word_t = uint64_t;
+
+        /**
+         * @brief The number of steps between two kept terms.
+         */
+        static constexpr size_type markInterval = 1 << 10;
+    public:
+        /**
+         * @brief Construct the trajectory of a run that has not started.
+         *
+         * @param uz the initial term
+         */
+        explicit Trajectory(const int64_t uz = 1)
+            : m_steps(0), m_bits(), m_marks({ uz }) {}
+
+        /**
+         * @brief Start another trajectory, keeping the storage.
+         *
+         * @param uz the initial term
+         */
+        inline void reset(const int64_t uz);
+
+        /**
+         * @brief Get the initial term.
+         *
+         * @return \f$u_0\f$
+         */
+        int64_t uz() const { return static_cast<int64_t>(m_marks.front()); }
+        /**
+         * @brief Get the number of steps.
+         *
+         * This is the length of the cycle of the run.
+         *
+         * @return the number of steps
+         */
+        size_type steps() const { return m_steps; }
+        /**
+         * @brief Get the number of terms, i.e. the number of steps plus
+         * one.
+         *
+         * @return the number of terms
+         */
+        size_type size() const { return m_steps + 1; }
+        /**
+         * @brief Get the parity bits.
+         *
+         * The bit of rank \f$r\f$ is the bit \f$r \bmod 64\f$ of the word
+         * \f$\lfloor r / 64 \rfloor\f$, and is set if \f$u_r\f$ is odd.
+         *
+         * @return the words of parity bits
+         */
+        const std::vector<word_t>& bits() const { return m_bits; }
+        /**
+         * @brief Get the number of bytes taken by the trajectory.
+         *
+         * @return the number of bytes
+         */
+        inline std::size_t bytes() const;
+
+        /**
+         * @brief Check whether a term is odd.
+         *
+         * @warning
+         * \p rank must be lower than `steps()`.
+         *
+         * @param rank the rank of the term
+         * @return     `true` if \f$u_{rank}\f$ is odd
+         */
+        inline bool odd(const size_type rank) const;
+        /**
+         * @brief Rebuild a term.
+         *
+         * @warning
+         * If \p rank is greater than `steps()`, an `std::out_of_range` is
+         * thrown.
+         *
+         * @param rank the rank of the term
+         * @return     \f$u_{rank}\f$
+         */
+        int128_t at(const size_type rank) const;
+        /**
+         * @brief Rebuild a range of terms.
+         *
+         * The range is truncated at the last term.
+         *
+         * @warning
+         * If \p first is greater than `steps()`, an `std::out_of_range` is
+         * thrown.
+         *
+         * @param first the rank of the first term
+         * @param count the number of terms
+         * @param terms the buffer receiving the terms, whose previous
+         *              contents are replaced
+         */
+        void terms(const size_type first, const size_type count,
+                   std::vector<int128_t>& terms) const;
+
+        /**
+         * @brief Record even steps.
+         *
+         * @param term  the current term, which must be divisible by
+         *              \f$2^{count}\f$
+         * @param count the number of halvings
+         */
+        inline void pushEvens(const int128_t term, const size_type count);
+        /**
+         * @brief Record an odd step.
+         *
+         * @param term the current term, which must be odd
+         */
+        inline void pushOdd(const int128_t term);
+    private:
+        inline void grow(const size_type steps);
+        static int128_t next(const int128_t term, const bool odd)
+        {
+            return odd ? 3 * term + 1 : term >> 1;
+        }
+    private:
+        size_type m_steps;
+        std::vector<word_t> m_bits;
+        std::vector<int128_t> m_marks;
+    };
+
+    inline void Trajectory::reset(const int64_t uz)
+    {
+        m_steps = 0;
+        m_bits.clear();
+        m_marks.assign(1, uz);
+    }
+
+    inline std::size_t Trajectory::bytes() const
+    {
+        return m_bits.size() * sizeof(word_t)
+               + m_marks.size() * sizeof(int128_t);
+    }
+
+    inline bool Trajectory::odd(const size_type rank) const
+    {
+        return (m_bits[rank / 64] >> (rank % 64)) & 1;
+    }
+
+    inline void Trajectory::pushEvens(const int128_t term,
+                                      const size_type count)
+    {
+        // The marks met by the halvings are the term shifted accordingly.
+        for (size_type mark = m_marks.size() * markInterval;
+             mark <= m_steps + count; mark += markInterval) {
+            m_marks.push_back(term >> (mark - m_steps));
+        }
+
+        grow(m_steps + count);
+    }
+
+    inline void Trajectory::pushOdd(const int128_t term)
+    {
+        grow(m_steps + 1);
+        m_bits[(m_steps - 1) / 64] |= word_t(1) << ((m_steps - 1) % 64);
+
+        if (m_steps % markInterval == 0)
+            m_marks.push_back(3 * term + 1);
+    }
+
+    inline void Trajectory::grow(const size_type steps)
+    {
+        m_steps = steps;
+
+        // The new bits are cleared, i.e. even.
+        m_bits.resize((m_steps + 63) / 64);
+    }
+}
+
+#endif // SYRACUSE_TRAJECTORY_HPP
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_VARINT_HPP
+#define SYRACUSE_VARINT_HPP
+
+#include "core/core.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace core
+{
+    __extension__ typedef unsigned __int128 uint128_t;
+
+    /**
+     * @brief Namespace providing the little-endian encodings of the binary
+     * files.
+     *
+     * The integers of variable length are written 7 bits at a time, the
+     * least significant ones first, the high bit of each byte telling
+     * whether another one follows. The signed ones are zigzag-encoded
+     * first, so that the integers close to zero stay short whatever their
+     * sign.
+     */
+    namespace varint
+    {
+        constexpr uint128_t zigzag(const int128_t n)
+        {
+            return (static_cast<uint128_t>(n) << 1)
+                   ^ static_cast<uint128_t>(n >> 127);
+        }
+
+        constexpr int128_t unzigzag(const uint128_t n)
+        {
+            return static_cast<int128_t>(n >> 1)
+                   ^ -static_cast<int128_t>(n & 1);
+        }
+
+        inline void put(std::vector<unsigned char>& out, uint128_t n)
+        {
+            while (n >= 0x80) {
+                out.push_back(static_cast<unsigned char>(n | 0x80));
+                n >>= 7;
+            }
+
+            out.push_back(static_cast<unsigned char>(n));
+        }
+
+        // Throws std::runtime_error if the integer does not end before
+        // end.
+        inline uint128_t get(const unsigned char*& p,
+                             const unsigned char* const end)
+        {
+            uint128_t ret = 0;
+
+            for (unsigned int shift = 0; shift < 128; shift += 7) {
+                if (p == end)
+                    break;
+
+                const unsigned char byte = *p++;
+                ret |= static_cast<uint128_t>(byte & 0x7f) << shift;
+
+                if ((byte & 0x80) == 0)
+                    return ret;
+            }
+
+            throw std::runtime_error("varint::get(): Truncated integer.");
+        }
+
+        template<typename Int>
+        void putFixed(std::vector<unsigned char>& out, const Int n)
+        {
+            for (unsigned int i = 0; i < sizeof(Int); ++i)
+                out.push_back(static_cast<unsigned char>(n >> (8 * i)));
+        }
+
+        template<typename Int>
+        Int getFixed(const unsigned char* const p)
+        {
+            uint64_t ret = 0;
+
+            for (unsigned int i = 0; i < sizeof(Int); ++i)
+                ret |= static_cast<uint64_t>(p[i]) << (8 * i);
+
+            return static_cast<Int>(ret);
+        }
+    }
+}
+
+#endif // SYRACUSE_VARINT_HPP
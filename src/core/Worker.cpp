@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/Worker.hpp"
+
+#include "core/BinaryWriter.hpp"
+#include "core/CollatzSequence.hpp"
+#include "core/JumpTable.hpp"
+#include "core/Protocol.hpp"
+#include "core/ResultCache.hpp"
+#include "core/Sweep.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+namespace sequence
+{
+    Worker::Worker(const size_type blockSize)
+        : m_blockSize(blockSize)
+        , m_jumps(std::make_shared<JumpTable>())
+        , m_cache() {}
+
+    Worker::~Worker() = default;
+
+    Worker::size_type Worker::run(core::Socket& socket)
+    {
+        core::Socket::Message hello{ protocol::Hello, {} };
+        core::varint::putFixed(hello.payload, protocol::version);
+        socket.send(hello);
+
+        for (size_type ret = 0;; ++ret) {
+            const auto message = socket.receive(1 << 20);
+
+            if (message.type == protocol::Done)
+                return ret;
+
+            const auto chunk = protocol::decode(message);
+
+            if (chunk.uz.size() != 1) {
+                throw std::runtime_error("Worker::run(): The initial terms "
+                                         "must count a single term.");
+            }
+
+            core::Socket::Message result{ protocol::Result, {} };
+            core::varint::putFixed(result.payload, chunk.ordinal);
+
+            const auto data = runChunk(chunk.uz, chunk.value, chunk.step,
+                                       chunk.count);
+            result.payload.insert(result.payload.end(), data.begin(),
+                                  data.end());
+
+            socket.send(result);
+        }
+    }
+
+    std::vector<unsigned char> Worker::runChunk(const Sequence::vec_t& uz,
+                                                const int64_t value,
+                                                const int64_t step,
+                                                const size_type count)
+    {
+        // The cache only holds the runs until its own target value.
+        if (!m_cache || (m_cache->value() != value))
+            m_cache = std::make_shared<ResultCache>(value, 1 << 20);
+
+        CollatzSequence seq(uz[0]);
+        seq.withJumpTable(m_jumps);
+        seq.withCache(m_cache);
+
+        const auto error = [] {
+            return std::runtime_error(std::string("Worker::runChunk(): ")
+                                      + std::strerror(errno));
+        };
+
+        const std::unique_ptr<std::FILE, int (*)(std::FILE*)>
+            file(std::tmpfile(), std::fclose);
+
+        if (!file)
+            throw error();
+
+        BinaryWriter writer(file.get(), value);
+        Sweep(seq, value, step).withBlockSize(m_blockSize).run(count,
+            [&](const ResultTable& block) {
+                writer.write(block);
+            });
+        writer.close();
+
+        // close() leaves the position after the header it rewrote.
+        if (std::fseek(file.get(), 0, SEEK_END) != 0)
+            throw error();
+
+        const long size = std::ftell(file.get());
+
+        if ((size < 0) || (std::fseek(file.get(), 0, SEEK_SET) != 0))
+            throw error();
+
+        std::vector<unsigned char> ret(static_cast<std::size_t>(size));
+
+        if (std::fread(ret.data(), 1, ret.size(), file.get()) != ret.size())
+            throw error();
+
+        return ret;
+    }
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_WORKER_HPP
+#define SYRACUSE_WORKER_HPP
+
+#include "core/Sequence.hpp"
+
+namespace core
+{
+    class Socket;
+}
+
+namespace sequence
+{
+    class JumpTable;
+    class ResultCache;
+
+    /**
+     * @class Worker core/Worker.hpp core/Worker.hpp
+     * @brief The node running the chunks handed out by a `Coordinator`.
+     *
+     * Each chunk is run by a `Sweep` of `CollatzSequence`, using all the
+     * threads of `ThreadPool::global()`, and its runs are sent back as a
+     * result file written by `BinaryWriter`.
+     *
+     * @par Example
+     *
+     * ```cpp
+     * core::Socket socket = core::Socket::connect("coordinator", 7420);
+     * sequence::Worker().run(socket);
+     * ```
+     *
+     * @see protocol
+     */
+    class Worker
+    {
+    public:
+        /**
+         * @brief Type representing a number of runs or chunks.
+         */
+        using size_type = uint64_t;
+    public:
+        /**
+         * @brief Construct a worker.
+         *
+         * @param blockSize the number of runs per block of the sweeps, or 0
+         *                  for the default one
+         */
+        explicit Worker(const size_type blockSize = 0);
+        /**
+         * @brief Release the tables of the runs.
+         */
+        ~Worker();
+
+        /**
+         * @brief Run chunks until the coordinator has none left.
+         *
+         * @exception std::runtime_error if the connection is lost or if the
+         * coordinator sends an invalid message
+         *
+         * @param socket the socket connected to the coordinator
+         * @return       the number of chunks run
+         */
+        size_type run(core::Socket& socket);
+    private:
+        std::vector<unsigned char> runChunk(const Sequence::vec_t& uz,
+                                            const int64_t value,
+                                            const int64_t step,
+                                            const size_type count);
+    private:
+        size_type m_blockSize;
+        Ref<const JumpTable> m_jumps;
+        Ref<ResultCache> m_cache;
+    };
+}
+
+#endif // SYRACUSE_WORKER_HPP
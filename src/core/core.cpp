@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "core/core.hpp"
+
+namespace core
+{
+    std::string toString(int128_t n)
+    {
+        if ((n >= INT64_MIN) && (n <= INT64_MAX))
+            return std::to_string(static_cast<int64_t>(n));
+
+        std::string ret;
+        const bool negative = (n < 0);
+
+        do {
+            const auto digit = static_cast<int>(n % 10);
+
+            ret.insert(ret.begin(),
+                       static_cast<char>('0' + (negative ? -digit : digit)));
+            n /= 10;
+        } while (n != 0);
+
+        if (negative)
+            ret.insert(ret.begin(), '-');
+
+        return ret;
+    }
+}
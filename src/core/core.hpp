@@ -16,7 +16,14 @@
  */
 
 
+#ifndef SYRACUSE_CORE_HPP
+#define SYRACUSE_CORE_HPP
+
+#include "core/Pool.hpp"
+
+#include <cstdint>
 #include <memory>
+#include <string>
 
 namespace core
 {
@@ -30,4 +37,10 @@ namespace core
         constexpr Aggregater(Args&&... args)
             : T{ std::forward<Args>(args)... } {}
     };
+
+    __extension__ typedef __int128 int128_t;
+
+    std::string toString(int128_t n);
 }
+
+#endif // SYRACUSE_CORE_HPP
@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "gui/MainWindow.hpp"
+
+#include "gui/PlotWidget.hpp"
+#include "gui/SweepRunner.hpp"
+#include "gui/TrajectoryWidget.hpp"
+
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QSplitter>
+#include <QStatusBar>
+#include <QVBoxLayout>
+
+#include <limits>
+
+namespace gui
+{
+    namespace
+    {
+        // The longest trajectory shown, far beyond any known cycle length.
+        constexpr std::size_t maxTrajectory = 1 << 20;
+
+        std::vector<double> trajectory(const int64_t uz, const int64_t value)
+        {
+            // Below it, 3n + 1 fits in 127 bits.
+            constexpr int128_t limit = int128_t(1) << 125;
+            std::vector<double> ret;
+            int128_t n = uz;
+
+            ret.push_back(static_cast<double>(n));
+
+            while ((n != value) && (n > 0) && (n < limit)
+                   && (ret.size() < maxTrajectory)) {
+                n = (n % 2 == 0) ? n / 2 : 3 * n + 1;
+                ret.push_back(static_cast<double>(n));
+            }
+
+            return ret;
+        }
+    }
+
+    MainWindow::MainWindow(QWidget* parent)
+        : QMainWindow(parent)
+        , m_first(new QLineEdit(QStringLiteral("1")))
+        , m_count(new QLineEdit(QStringLiteral("10000000")))
+        , m_value(new QLineEdit(QStringLiteral("1")))
+        , m_step(new QLineEdit(QStringLiteral("1")))
+        , m_run(new QPushButton(tr("&Run")))
+        , m_stop(new QPushButton(tr("&Stop")))
+        , m_cycleLens(new PlotWidget(PlotWidget::CycleLen))
+        , m_maxTerms(new PlotWidget(PlotWidget::MaxTerm))
+        , m_trajectory(new TrajectoryWidget)
+        , m_progress(new QProgressBar)
+        , m_status(new QLabel)
+        , m_runner(new SweepRunner(this))
+        , m_timer()
+        , m_elapsed()
+        , m_version(0)
+        , m_sweepFirst(1)
+        , m_sweepValue(1)
+        , m_sweepStep(1)
+    {
+        auto form = new QHBoxLayout;
+        form->addWidget(new QLabel(tr("First:")));
+        form->addWidget(m_first);
+        form->addWidget(new QLabel(tr("Count:")));
+        form->addWidget(m_count);
+        form->addWidget(new QLabel(tr("Until:")));
+        form->addWidget(m_value);
+        form->addWidget(new QLabel(tr("Step:")));
+        form->addWidget(m_step);
+        form->addWidget(m_run);
+        form->addWidget(m_stop);
+
+        auto plots = new QSplitter(Qt::Vertical);
+        plots->addWidget(m_cycleLens);
+        plots->addWidget(m_maxTerms);
+        plots->addWidget(m_trajectory);
+
+        auto central = new QWidget;
+        auto layout = new QVBoxLayout(central);
+        layout->addLayout(form);
+        layout->addWidget(plots, 1);
+        setCentralWidget(central);
+
+        m_progress->setRange(0, 1000);
+        m_progress->setTextVisible(false);
+        statusBar()->addWidget(m_status, 1);
+        statusBar()->addPermanentWidget(m_progress);
+
+        m_stop->setEnabled(false);
+        setWindowTitle(tr("Syracuse"));
+
+        connect(m_run, &QPushButton::clicked, this, &MainWindow::start);
+        connect(m_stop, &QPushButton::clicked, m_runner, &SweepRunner::stop);
+        connect(m_runner, &SweepRunner::finished, this, &MainWindow::finish);
+        connect(m_cycleLens, &PlotWidget::runSelected,
+                this, &MainWindow::showTrajectory);
+        connect(m_maxTerms, &PlotWidget::runSelected,
+                this, &MainWindow::showTrajectory);
+
+        // Once per frame at 60 Hz.
+        m_timer.setInterval(16);
+        connect(&m_timer, &QTimer::timeout, this, &MainWindow::refresh);
+    }
+
+    void MainWindow::start()
+    {
+        bool ok[4];
+        const qlonglong first = m_first->text().toLongLong(&ok[0]);
+        const qulonglong count = m_count->text().toULongLong(&ok[1]);
+        const qlonglong value = m_value->text().toLongLong(&ok[2]);
+        const qlonglong step = m_step->text().toLongLong(&ok[3]);
+
+        if (!ok[0] || !ok[1] || !ok[2] || !ok[3] || (count == 0)) {
+            QMessageBox::warning(this, windowTitle(),
+                                 tr("The parameters must be integers, and "
+                                    "there must be at least one run."));
+            return;
+        }
+
+        m_sweepFirst = first;
+        m_sweepValue = value;
+        m_sweepStep = step;
+        // The plots of the previous sweep are cleared by the first frame.
+        m_version = std::numeric_limits<uint64_t>::max();
+
+        m_runner->start(first, count, value, step);
+        m_run->setEnabled(false);
+        m_stop->setEnabled(true);
+        m_status->setText(tr("Running…"));
+        m_elapsed.start();
+        m_timer.start();
+        refresh();
+    }
+
+    void MainWindow::refresh()
+    {
+        const auto decimator = m_runner->decimator();
+
+        if (!decimator || (decimator->version() == m_version))
+            return;
+
+        // The version is read first, so that a change made meanwhile is
+        // drawn by the next frame.
+        m_version = decimator->version();
+        const auto bins = decimator->bins();
+        const auto added = decimator->added();
+
+        m_cycleLens->setBins(bins, m_sweepFirst, m_sweepStep,
+                             decimator->size());
+        m_maxTerms->setBins(bins, m_sweepFirst, m_sweepStep,
+                            decimator->size());
+        m_progress->setValue(static_cast<int>(added * 1000
+                                              / decimator->size()));
+        m_status->setText(tr("%1 of %2 runs in %3 s")
+                              .arg(added)
+                              .arg(decimator->size())
+                              .arg(m_elapsed.elapsed() / 1000.0, 0, 'f', 1));
+    }
+
+    void MainWindow::finish(const QString& error)
+    {
+        m_timer.stop();
+        refresh();
+
+        m_run->setEnabled(true);
+        m_stop->setEnabled(false);
+
+        if (!error.isEmpty()) {
+            m_status->setText(tr("Failed: %1").arg(error));
+            QMessageBox::warning(this, windowTitle(), error);
+        }
+    }
+
+    void MainWindow::showTrajectory(const quint64 ordinal, const qint64 uz)
+    {
+        auto terms = trajectory(uz, m_sweepValue);
+        const QString title = tr("Trajectory of %1 (run %2, %3 steps)")
+                                  .arg(uz)
+                                  .arg(ordinal)
+                                  .arg(terms.size() - 1);
+
+        m_trajectory->setTrajectory(title, std::move(terms));
+    }
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_MAIN_WINDOW_HPP
+#define SYRACUSE_MAIN_WINDOW_HPP
+
+#include <QElapsedTimer>
+#include <QMainWindow>
+#include <QTimer>
+
+#include <cstdint>
+
+class QLabel;
+class QLineEdit;
+class QProgressBar;
+class QPushButton;
+
+namespace gui
+{
+    class PlotWidget;
+    class SweepRunner;
+    class TrajectoryWidget;
+
+    /**
+     * @class MainWindow gui/MainWindow.hpp gui/MainWindow.hpp
+     * @brief The main window, running sweeps and plotting them as they go.
+     *
+     * The plots are refreshed at most once per frame, and only when new
+     * runs were added, so that the event loop stays responsive whatever the
+     * size of the sweep.
+     */
+    class MainWindow : public QMainWindow
+    {
+        Q_OBJECT
+
+    public:
+        /**
+         * @brief Construct the window.
+         *
+         * @param parent the parent widget
+         */
+        explicit MainWindow(QWidget* parent = nullptr);
+    private slots:
+        void start();
+        void refresh();
+        void finish(const QString& error);
+        void showTrajectory(quint64 ordinal, qint64 uz);
+    private:
+        QLineEdit* m_first;
+        QLineEdit* m_count;
+        QLineEdit* m_value;
+        QLineEdit* m_step;
+        QPushButton* m_run;
+        QPushButton* m_stop;
+        PlotWidget* m_cycleLens;
+        PlotWidget* m_maxTerms;
+        TrajectoryWidget* m_trajectory;
+        QProgressBar* m_progress;
+        QLabel* m_status;
+
+        SweepRunner* m_runner;
+        QTimer m_timer;
+        QElapsedTimer m_elapsed;
+        uint64_t m_version;
+
+        // The parameters of the current sweep.
+        int64_t m_sweepFirst;
+        int64_t m_sweepValue;
+        int64_t m_sweepStep;
+    };
+}
+
+#endif // SYRACUSE_MAIN_WINDOW_HPP
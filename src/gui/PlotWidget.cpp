@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "gui/PlotWidget.hpp"
+
+#include <QMouseEvent>
+#include <QPainter>
+
+#include <algorithm>
+#include <cmath>
+
+namespace gui
+{
+    PlotWidget::PlotWidget(const Statistic statistic, QWidget* parent)
+        : QWidget(parent)
+        , m_statistic(statistic)
+        , m_bins()
+        , m_first(0)
+        , m_step(1)
+        , m_n(0)
+    {
+        setAttribute(Qt::WA_OpaquePaintEvent);
+    }
+
+    void PlotWidget::setBins(std::vector<sequence::Decimator::Bin> bins,
+                             const int64_t first, const int64_t step,
+                             const uint64_t n)
+    {
+        m_bins = std::move(bins);
+        m_first = first;
+        m_step = step;
+        m_n = n;
+
+        update();
+    }
+
+    void PlotWidget::paintEvent(QPaintEvent*)
+    {
+        QPainter painter(this);
+        painter.fillRect(rect(), palette().base());
+
+        const QRect area = plotArea();
+        const auto cols = columns(area.width());
+
+        double lo = std::numeric_limits<double>::infinity();
+        double hi = -lo;
+
+        for (const auto& i : cols) {
+            if (i.valid) {
+                lo = std::min(lo, i.min);
+                hi = std::max(hi, i.max);
+            }
+        }
+
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(rect().adjusted(0, 2, 0, 0),
+                         Qt::AlignHCenter | Qt::AlignTop,
+                         (m_statistic == CycleLen) ? tr("Cycle length")
+                                                   : tr("Maximum term"));
+
+        if (lo > hi) {
+            painter.drawText(area, Qt::AlignCenter, tr("No runs"));
+            return;
+        }
+
+        if (m_statistic == CycleLen)
+            lo = 0;
+
+        if (hi <= lo)
+            hi = lo + 1;
+
+        const auto label = [this](const double y) {
+            return (m_statistic == CycleLen)
+                       ? QString::number(y, 'f', 0)
+                       : QString::number(std::pow(10, y), 'g', 3);
+        };
+
+        painter.drawText(QRect(0, area.top(), area.left() - 4, 20),
+                         Qt::AlignRight | Qt::AlignTop, label(hi));
+        painter.drawText(QRect(0, area.bottom() - 20, area.left() - 4, 20),
+                         Qt::AlignRight | Qt::AlignBottom, label(lo));
+        painter.drawText(QRect(area.left(), area.bottom() + 2,
+                               area.width(), 20),
+                         Qt::AlignLeft | Qt::AlignTop,
+                         QString::number(m_first));
+        painter.drawText(QRect(area.left(), area.bottom() + 2,
+                               area.width(), 20),
+                         Qt::AlignRight | Qt::AlignTop,
+                         QString::number(m_first
+                                         + static_cast<int64_t>(m_n - 1)
+                                           * m_step));
+        painter.drawRect(area.adjusted(-1, -1, 0, 0));
+
+        const double height = area.height() - 1;
+        const auto y = [&](const double v) {
+            return area.bottom() - (v - lo) / (hi - lo) * height;
+        };
+
+        painter.setPen(palette().color(QPalette::Highlight));
+
+        for (std::size_t i = 0; i < cols.size(); ++i) {
+            if (cols[i].valid) {
+                const double x = area.left() + static_cast<double>(i) + 0.5;
+                painter.drawLine(QPointF(x, y(cols[i].min)),
+                                 QPointF(x, y(cols[i].max)));
+            }
+        }
+    }
+
+    void PlotWidget::mousePressEvent(QMouseEvent* event)
+    {
+        const QRect area = plotArea();
+        const int x = event->pos().x() - area.left();
+
+        if ((event->button() != Qt::LeftButton) || (x < 0)
+            || (x >= area.width())) {
+            QWidget::mousePressEvent(event);
+            return;
+        }
+
+        const auto cols = columns(area.width());
+        const auto& col = cols[static_cast<std::size_t>(x)];
+
+        if (col.valid) {
+            emit runSelected(col.run,
+                             m_first + static_cast<int64_t>(col.run) * m_step);
+        }
+    }
+
+    QRect PlotWidget::plotArea() const
+    {
+        return rect().adjusted(64, 20, -8, -22);
+    }
+
+    std::vector<PlotWidget::Column> PlotWidget::columns(const int width) const
+    {
+        std::vector<Column> ret(static_cast<std::size_t>(std::max(width, 0)),
+                                Column{ false, 0, 0, 0 });
+        const std::size_t n = m_bins.size();
+
+        if (n == 0)
+            return ret;
+
+        for (std::size_t x = 0; x < ret.size(); ++x) {
+            // Each column merges the bins it covers, or shows the bin under
+            // it if they are fewer than the columns.
+            const std::size_t begin = x * n / ret.size();
+            const std::size_t end = std::max(begin + 1,
+                                             (x + 1) * n / ret.size());
+            sequence::Decimator::Bin bin;
+
+            for (std::size_t i = begin; i < end; ++i)
+                bin.merge(m_bins[i]);
+
+            if (bin.runs == 0)
+                continue;
+
+            if (m_statistic == CycleLen) {
+                ret[x] = { true, static_cast<double>(bin.minCycleLen),
+                           static_cast<double>(bin.maxCycleLen),
+                           bin.longestRun };
+            } else {
+                ret[x] = { true, scale(bin.minMaxTerm), scale(bin.maxMaxTerm),
+                           bin.highestRun };
+            }
+        }
+
+        return ret;
+    }
+
+    double PlotWidget::scale(const double y) const
+    {
+        return std::log10(std::max(y, 1.0));
+    }
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_PLOT_WIDGET_HPP
+#define SYRACUSE_PLOT_WIDGET_HPP
+
+#include "core/Decimator.hpp"
+
+#include <QWidget>
+
+namespace gui
+{
+    /**
+     * @class PlotWidget gui/PlotWidget.hpp gui/PlotWidget.hpp
+     * @brief A plot of a statistic of the runs of a sweep against their
+     * initial term.
+     *
+     * The bins of a `Decimator` are merged down to the width of the widget,
+     * each column of pixels being drawn as a single segment from the
+     * minimum to the maximum of its runs. Drawing thus costs the same
+     * whatever the number of runs.
+     */
+    class PlotWidget : public QWidget
+    {
+        Q_OBJECT
+
+    public:
+        /**
+         * @brief Type representing the statistic plotted.
+         */
+        enum Statistic
+        {
+            /**
+             * @brief The cycle length, on a linear scale.
+             */
+            CycleLen,
+            /**
+             * @brief The maximum term, on a logarithmic scale.
+             */
+            MaxTerm
+        };
+    public:
+        /**
+         * @brief Construct an empty plot.
+         *
+         * @param statistic the statistic plotted
+         * @param parent    the parent widget
+         */
+        explicit PlotWidget(const Statistic statistic,
+                            QWidget* parent = nullptr);
+
+        /**
+         * @brief Set the runs plotted.
+         *
+         * @param bins  the bins of the runs
+         * @param first the initial term of the first run
+         * @param step  the step incrementing the initial terms
+         * @param n     the number of runs of the sweep
+         */
+        void setBins(std::vector<sequence::Decimator::Bin> bins,
+                     const int64_t first, const int64_t step,
+                     const uint64_t n);
+
+        QSize minimumSizeHint() const override { return QSize(200, 120); }
+        QSize sizeHint() const override { return QSize(640, 240); }
+    signals:
+        /**
+         * @brief Emitted when a column is clicked.
+         *
+         * @param ordinal the run of the column with the highest statistic
+         * @param uz      the initial term of the run
+         */
+        void runSelected(quint64 ordinal, qint64 uz);
+    protected:
+        void paintEvent(QPaintEvent* event) override;
+        void mousePressEvent(QMouseEvent* event) override;
+    private:
+        struct Column
+        {
+            bool valid;
+            double min;
+            double max;
+            uint64_t run;
+        };
+    private:
+        QRect plotArea() const;
+        std::vector<Column> columns(const int width) const;
+        double scale(const double y) const;
+    private:
+        Statistic m_statistic;
+        std::vector<sequence::Decimator::Bin> m_bins;
+        int64_t m_first;
+        int64_t m_step;
+        uint64_t m_n;
+    };
+}
+
+#endif // SYRACUSE_PLOT_WIDGET_HPP
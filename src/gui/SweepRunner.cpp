@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "gui/SweepRunner.hpp"
+
+#include "core/CollatzSequence.hpp"
+#include "core/JumpTable.hpp"
+#include "core/ResultCache.hpp"
+#include "core/SweepJob.hpp"
+
+#include <QMetaObject>
+
+namespace gui
+{
+    SweepRunner::SweepRunner(QObject* parent)
+        : QObject(parent)
+        , m_seq()
+        , m_job()
+        , m_decimator() {}
+
+    SweepRunner::~SweepRunner()
+    {
+        // The job is cancelled and waited for before the sequence it runs is
+        // destructed. The queued call to join() is dropped along with this
+        // object.
+        m_job.reset();
+    }
+
+    void SweepRunner::start(const int64_t first, const uint64_t n,
+                            const int64_t value, const int64_t step)
+    {
+        m_decimator = std::make_shared<sequence::Decimator>(n);
+
+        m_seq = std::make_unique<sequence::CollatzSequence>(first);
+        m_seq->withJumpTable(std::make_shared<sequence::JumpTable>());
+        m_seq->withCache(std::make_shared<sequence::ResultCache>(value,
+                                                                 1 << 20));
+
+        m_job = sequence::Sweep(*m_seq, value, step).start(n,
+            [decimator = m_decimator](const sequence::ResultTable& block) {
+                decimator->add(block);
+            },
+            [this](const std::exception_ptr& failure) {
+                QString error;
+
+                try {
+                    if (failure)
+                        std::rethrow_exception(failure);
+                } catch (const std::exception& e) {
+                    error = QString::fromStdString(e.what());
+                }
+
+                QMetaObject::invokeMethod(this, [this, error] { join(error); },
+                                          Qt::QueuedConnection);
+            });
+    }
+
+    void SweepRunner::stop()
+    {
+        if (m_job)
+            m_job->cancel();
+    }
+
+    void SweepRunner::join(const QString& error)
+    {
+        m_job.reset();
+        emit finished(error);
+    }
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_SWEEP_RUNNER_HPP
+#define SYRACUSE_SWEEP_RUNNER_HPP
+
+#include "core/Decimator.hpp"
+
+#include <QObject>
+
+namespace sequence
+{
+    class CollatzSequence;
+    class SweepJob;
+}
+
+namespace gui
+{
+    /**
+     * @class SweepRunner gui/SweepRunner.hpp gui/SweepRunner.hpp
+     * @brief A sweep of the Syracuse sequence run in the background.
+     *
+     * The sweep is run by a `SweepJob`, its blocks being evaluated by
+     * `ThreadPool::global()`, and is reduced on the fly by a
+     * `Decimator`. The event loop never waits for it: the widgets poll
+     * `decimator()` at their own pace, and `finished()` is emitted once the
+     * sweep is over.
+     */
+    class SweepRunner : public QObject
+    {
+        Q_OBJECT
+
+    public:
+        /**
+         * @brief Construct an idle runner.
+         *
+         * @param parent the parent object
+         */
+        explicit SweepRunner(QObject* parent = nullptr);
+        /**
+         * @brief Stop the sweep and wait for it.
+         */
+        ~SweepRunner() override;
+
+        /**
+         * @brief Check whether a sweep is running.
+         *
+         * @return `true` if `finished()` is still to be emitted
+         */
+        bool isRunning() const { return static_cast<bool>(m_job); }
+        /**
+         * @brief Get the runs of the current sweep, or of the last one.
+         *
+         * @return a pointer to the decimator, or `nullptr` before the first
+         *         sweep
+         */
+        Ref<const sequence::Decimator> decimator() const { return m_decimator; }
+
+        /**
+         * @brief Start a sweep.
+         *
+         * @warning
+         * No sweep must be running.
+         *
+         * @param first the first initial term
+         * @param n     the number of runs
+         * @param value run the sequence until
+         * @param step  the step incrementing the initial terms
+         */
+        void start(const int64_t first, const uint64_t n, const int64_t value,
+                   const int64_t step);
+        /**
+         * @brief Ask the sweep to stop.
+         *
+         * The blocks not yet started are skipped, `finished()` being
+         * emitted once the running ones are done.
+         */
+        void stop();
+    signals:
+        /**
+         * @brief Emitted when the sweep is over.
+         *
+         * @param error the error which stopped the sweep, or an empty
+         *              string if it was done or stopped by `stop()`
+         */
+        void finished(const QString& error);
+    private:
+        void join(const QString& error);
+    private:
+        std::unique_ptr<sequence::CollatzSequence> m_seq;
+        Ref<sequence::SweepJob> m_job;
+        Ref<sequence::Decimator> m_decimator;
+    };
+}
+
+#endif // SYRACUSE_SWEEP_RUNNER_HPP
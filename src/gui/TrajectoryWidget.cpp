@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "gui/TrajectoryWidget.hpp"
+
+#include <QPainter>
+#include <QPainterPath>
+
+#include <algorithm>
+#include <cmath>
+
+namespace gui
+{
+    TrajectoryWidget::TrajectoryWidget(QWidget* parent)
+        : QWidget(parent)
+        , m_title(tr("Click a plot to show a trajectory"))
+        , m_terms()
+    {
+        setAttribute(Qt::WA_OpaquePaintEvent);
+    }
+
+    void TrajectoryWidget::setTrajectory(const QString& title,
+                                         std::vector<double> terms)
+    {
+        m_title = title;
+        m_terms = std::move(terms);
+
+        for (auto& i : m_terms)
+            i = std::log10(std::max(i, 1.0));
+
+        update();
+    }
+
+    void TrajectoryWidget::paintEvent(QPaintEvent*)
+    {
+        QPainter painter(this);
+        painter.fillRect(rect(), palette().base());
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(rect().adjusted(0, 2, 0, 0),
+                         Qt::AlignHCenter | Qt::AlignTop, m_title);
+
+        if (m_terms.empty())
+            return;
+
+        const QRect area = rect().adjusted(64, 20, -8, -22);
+        const auto bounds = std::minmax_element(m_terms.begin(), m_terms.end());
+        const double lo = *bounds.first;
+        const double hi = std::max(*bounds.second, lo + 1);
+
+        painter.drawText(QRect(0, area.top(), area.left() - 4, 20),
+                         Qt::AlignRight | Qt::AlignTop,
+                         QString::number(std::pow(10, hi), 'g', 3));
+        painter.drawText(QRect(0, area.bottom() - 20, area.left() - 4, 20),
+                         Qt::AlignRight | Qt::AlignBottom,
+                         QString::number(std::pow(10, lo), 'g', 3));
+        painter.drawText(QRect(area.left(), area.bottom() + 2,
+                               area.width(), 20),
+                         Qt::AlignRight | Qt::AlignTop,
+                         QString::number(m_terms.size() - 1));
+        painter.drawRect(area.adjusted(-1, -1, 0, 0));
+
+        const double height = area.height() - 1;
+        const auto y = [&](const double v) {
+            return area.bottom() - (v - lo) / (hi - lo) * height;
+        };
+
+        painter.setPen(palette().color(QPalette::Highlight));
+
+        const std::size_t n = m_terms.size();
+        const auto width = static_cast<std::size_t>(std::max(area.width(), 1));
+
+        if (n <= width) {
+            QPainterPath path;
+            const double dx = (n > 1) ? (area.width() - 1)
+                                            / static_cast<double>(n - 1)
+                                      : 0;
+
+            path.moveTo(area.left(), y(m_terms[0]));
+
+            for (std::size_t i = 1; i < n; ++i) {
+                path.lineTo(area.left() + dx * static_cast<double>(i),
+                            y(m_terms[i]));
+            }
+
+            painter.drawPath(path);
+            return;
+        }
+
+        for (std::size_t x = 0; x < width; ++x) {
+            // The column joins the last term of the previous one, so that
+            // the plot stays connected.
+            const std::size_t begin = (x == 0) ? 0 : x * n / width - 1;
+            const std::size_t end = (x + 1) * n / width;
+            const auto first = m_terms.begin();
+            const auto column = std::minmax_element(
+                first + static_cast<std::ptrdiff_t>(begin),
+                first + static_cast<std::ptrdiff_t>(end));
+            const double px = area.left() + static_cast<double>(x) + 0.5;
+
+            painter.drawLine(QPointF(px, y(*column.first)),
+                             QPointF(px, y(*column.second)));
+        }
+    }
+}
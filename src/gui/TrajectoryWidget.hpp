@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2020 Mattéo Rossillol‑‑Laruelle <beatussum@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYRACUSE_TRAJECTORY_WIDGET_HPP
+#define SYRACUSE_TRAJECTORY_WIDGET_HPP
+
+#include <QWidget>
+
+#include <vector>
+
+namespace gui
+{
+    /**
+     * @class TrajectoryWidget gui/TrajectoryWidget.hpp gui/TrajectoryWidget.hpp
+     * @brief A plot of the terms of a run against their rank, on a
+     * logarithmic scale.
+     *
+     * As with `PlotWidget`, the terms sharing a column of pixels are drawn
+     * as a single segment when they outnumber the columns.
+     */
+    class TrajectoryWidget : public QWidget
+    {
+        Q_OBJECT
+
+    public:
+        /**
+         * @brief Construct an empty plot.
+         *
+         * @param parent the parent widget
+         */
+        explicit TrajectoryWidget(QWidget* parent = nullptr);
+
+        /**
+         * @brief Set the run plotted.
+         *
+         * @param title the title of the plot
+         * @param terms the terms of the run, from its initial term
+         */
+        void setTrajectory(const QString& title, std::vector<double> terms);
+
+        QSize minimumSizeHint() const override { return QSize(200, 120); }
+        QSize sizeHint() const override { return QSize(640, 240); }
+    protected:
+        void paintEvent(QPaintEvent* event) override;
+    private:
+        QString m_title;
+        std::vector<double> m_terms;
+    };
+}
+
+#endif // SYRACUSE_TRAJECTORY_WIDGET_HPP
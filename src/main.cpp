@@ -16,10 +16,15 @@
  */
 
 
+#include "gui/MainWindow.hpp"
+
 #include <QApplication>
 
 int main(int argc, char* argv[]) {
     QApplication app(argc, argv);
 
+    gui::MainWindow window;
+    window.show();
+
     return app.exec();
 }